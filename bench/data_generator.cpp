@@ -0,0 +1,521 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+
+/**
+ * Generador de conjuntos de datos sintéticos (make generate_synthetic).
+ *
+ * generate_test_data.sh solo produce tres extremos (un único byte, /dev/urandom y el patrón
+ * "0123456789", que no tiene ninguna corrida). Este generador produce archivos con:
+ *   - longitudes de corrida geométricas, Zipf, bimodales o fijas (--runs),
+ *   - una fracción configurable de corridas de bytes bandera 0xFE/0xFF (--flags),
+ *   - regiones incompresibles intercaladas con las compresibles (--mix),
+ *   - corridas que cruzan las fronteras de Calcular_Particion para uno o varios P (--straddle).
+ *
+ * La salida se escribe por bloques de 4 MiB, de modo que el tamaño (--size) puede ser de cientos
+ * de GB sin usar más memoria. Con la misma semilla (--seed) y las mismas opciones el archivo es
+ * idéntico byte a byte: el muestreo usa mt19937_64 (cuya secuencia fija el estándar) y no las
+ * distribuciones de <random>, que cambian entre bibliotecas.
+ *
+ * No necesita MPI_Init: de la biblioteca solo usa Calcular_Particion, que es aritmética pura.
+ */
+
+#include "../include/RLECompressor.hpp"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+static const size_t TAMANO_BUFFER = (size_t)4 << 20;
+
+// --- Configuración ---
+
+enum class Distribucion { Geometrica, Zipf, Bimodal, Fija };
+
+struct Configuracion {
+    uint64_t tamano = (uint64_t)100 << 20;       // --size
+    uint64_t semilla = 1;                        // --seed
+    string salida;                               // --output ("-" para stdout)
+
+    Distribucion distribucion = Distribucion::Geometrica;  // --runs
+    double media = 16.0;                         // geometric:<media>, fixed:<n>
+    double exponente = 1.1;                      // zipf:<s>:<max>
+    uint64_t maximo = 65536;
+    double media_corta = 2.0;                    // bimodal:<corta>:<larga>:<prob_larga>
+    double media_larga = 1024.0;
+    double prob_larga = 0.05;
+
+    int alfabeto = 256;                          // --alphabet: valores 0..N-1 de las corridas
+    double banderas = -1.0;                      // --flags: fracción de corridas 0xFE/0xFF (<0: sin forzar)
+
+    double fraccion_aleatoria = 0.0;             // --mix <fracción>:<MiB>
+    uint64_t region = (uint64_t)4 << 20;
+
+    vector<int> procesos;                        // --straddle P1,P2,...
+    uint64_t longitud_frontera = 300;            // --straddle-length (>255: también parte el conteo de 1 byte)
+};
+
+// Formas predefinidas (--preset) que usan run_benchmarks.sh (SYNTHETIC) y make generate_synthetic
+static bool Aplicar_Preset(const string& nombre, Configuracion& config) {
+    if (nombre == "geometrica") {
+        config.distribucion = Distribucion::Geometrica;
+        config.media = 32.0;
+    } else if (nombre == "zipf") {
+        // Muchas corridas cortas y una cola larga de corridas de miles de bytes
+        config.distribucion = Distribucion::Zipf;
+        config.exponente = 1.1;
+        config.maximo = 65536;
+    } else if (nombre == "bimodal") {
+        config.distribucion = Distribucion::Bimodal;
+        config.media_corta = 2.0;
+        config.media_larga = 2048.0;
+        config.prob_larga = 0.05;
+    } else if (nombre == "banderas") {
+        config.distribucion = Distribucion::Geometrica;
+        config.media = 8.0;
+        config.banderas = 0.25;
+    } else if (nombre == "mixta") {
+        config.distribucion = Distribucion::Geometrica;
+        config.media = 64.0;
+        config.fraccion_aleatoria = 0.5;
+        config.region = (uint64_t)4 << 20;
+    } else if (nombre == "fronteras") {
+        // Corridas cortas salvo las que cruzan las fronteras de los P de run_benchmarks.sh
+        config.distribucion = Distribucion::Geometrica;
+        config.media = 4.0;
+        config.procesos = {2, 4, 6, 8, 10, 16};
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// --- Lectura de opciones ---
+
+// Tamaño con sufijo binario opcional: 512, 64K, 100M, 2G, 1T
+static bool Leer_Tamano(const string& texto, uint64_t& tamano) {
+    char* fin = nullptr;
+    unsigned long long valor = strtoull(texto.c_str(), &fin, 10);
+    if (fin == texto.c_str()) return false;
+    int desplazamiento = 0;
+    switch (*fin) {
+        case '\0': break;
+        case 'K': case 'k': desplazamiento = 10; ++fin; break;
+        case 'M': case 'm': desplazamiento = 20; ++fin; break;
+        case 'G': case 'g': desplazamiento = 30; ++fin; break;
+        case 'T': case 't': desplazamiento = 40; ++fin; break;
+        default: return false;
+    }
+    if (*fin != '\0') return false;
+    tamano = (uint64_t)valor << desplazamiento;
+    return true;
+}
+
+static vector<string> Separar(const string& texto, char separador) {
+    vector<string> partes;
+    size_t inicio = 0;
+    while (true) {
+        size_t fin = texto.find(separador, inicio);
+        partes.push_back(texto.substr(inicio, fin == string::npos ? string::npos : fin - inicio));
+        if (fin == string::npos) break;
+        inicio = fin + 1;
+    }
+    return partes;
+}
+
+static bool Leer_Distribucion(const string& texto, Configuracion& config) {
+    vector<string> partes = Separar(texto, ':');
+    const string& nombre = partes[0];
+    if (nombre == "geometric" && partes.size() == 2) {
+        config.distribucion = Distribucion::Geometrica;
+        config.media = atof(partes[1].c_str());
+        return config.media >= 1.0;
+    }
+    if (nombre == "fixed" && partes.size() == 2) {
+        config.distribucion = Distribucion::Fija;
+        config.media = atof(partes[1].c_str());
+        return config.media >= 1.0;
+    }
+    if (nombre == "zipf" && partes.size() == 3) {
+        config.distribucion = Distribucion::Zipf;
+        config.exponente = atof(partes[1].c_str());
+        config.maximo = strtoull(partes[2].c_str(), nullptr, 10);
+        return config.exponente > 0.0 && config.maximo >= 1 && config.maximo <= ((uint64_t)1 << 24);
+    }
+    if (nombre == "bimodal" && partes.size() == 4) {
+        config.distribucion = Distribucion::Bimodal;
+        config.media_corta = atof(partes[1].c_str());
+        config.media_larga = atof(partes[2].c_str());
+        config.prob_larga = atof(partes[3].c_str());
+        return config.media_corta >= 1.0 && config.media_larga >= 1.0 &&
+               config.prob_larga >= 0.0 && config.prob_larga <= 1.0;
+    }
+    return false;
+}
+
+// --- Muestreo ---
+
+class Generador {
+public:
+    explicit Generador(const Configuracion& config) : config(config), rng(config.semilla) {
+        escala = Escala_Geometrica(config.media);
+        escala_corta = Escala_Geometrica(config.media_corta);
+        escala_larga = Escala_Geometrica(config.media_larga);
+        if (config.distribucion == Distribucion::Zipf) {
+            // CDF acumulada de P(k) ∝ 1/k^s, k = 1..max; se muestrea con búsqueda binaria
+            cdf.resize(config.maximo);
+            double acumulado = 0.0;
+            for (uint64_t k = 1; k <= config.maximo; ++k) {
+                acumulado += pow((double)k, -config.exponente);
+                cdf[k - 1] = acumulado;
+            }
+        }
+    }
+
+    // Uniforme en (0, 1]
+    double Uniforme() {
+        return (double)((rng() >> 11) + 1) * (1.0 / 9007199254740992.0);
+    }
+
+    uint64_t Longitud() {
+        switch (config.distribucion) {
+            case Distribucion::Geometrica:
+                return Geometrica(escala);
+            case Distribucion::Fija:
+                return (uint64_t)config.media;
+            case Distribucion::Bimodal:
+                return Geometrica(Uniforme() <= config.prob_larga ? escala_larga : escala_corta);
+            case Distribucion::Zipf: {
+                double u = Uniforme() * cdf.back();
+                return (uint64_t)(lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin()) + 1;
+            }
+        }
+        return 1;
+    }
+
+    // Valor de una corrida distinto del byte anterior, para que las corridas no se fusionen
+    uint8_t Valor(int anterior) {
+        uint8_t valor;
+        do {
+            if (config.banderas >= 0.0) {
+                if (Uniforme() <= config.banderas) {
+                    valor = (rng() & 1) ? 0xFF : 0xFE;
+                } else {
+                    // Solo valores que no son bandera (el alfabeto se recorta a 0..253)
+                    valor = Entero(min(config.alfabeto, 254));
+                }
+            } else {
+                valor = Entero(config.alfabeto);
+            }
+        } while ((int)valor == anterior && Puede_Cambiar());
+        return valor;
+    }
+
+    bool Region_Aleatoria() {
+        return config.fraccion_aleatoria > 0.0 && Uniforme() <= config.fraccion_aleatoria;
+    }
+
+    void Bytes_Aleatorios(uint8_t* destino, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t x = rng();
+            memcpy(destino + i, &x, 8);
+        }
+        if (i < n) {
+            uint64_t x = rng();
+            memcpy(destino + i, &x, n - i);
+        }
+    }
+
+private:
+    // Entero en [0, n) por multiplicación (sin la división de rng() % n)
+    uint8_t Entero(int n) {
+        return (uint8_t)(((rng() >> 32) * (uint64_t)n) >> 32);
+    }
+
+    // Número de ensayos hasta el primer éxito con p = 1/media (media exacta):
+    // 1 + floor(ln(U) / ln(1 - p)); la escala 1/ln(1 - p) se calcula una sola vez
+    static double Escala_Geometrica(double media) {
+        return media > 1.0 ? 1.0 / log1p(-1.0 / media) : 0.0;
+    }
+
+    uint64_t Geometrica(double escala) {
+        if (escala == 0.0) return 1;
+        double l = floor(log(Uniforme()) * escala);
+        return 1 + (uint64_t)min(l, 4294967296.0);
+    }
+
+    // Con un alfabeto de un valor y sin banderas no hay otro valor posible
+    bool Puede_Cambiar() const {
+        return config.alfabeto > 1 || config.banderas > 0.0;
+    }
+
+    const Configuracion& config;
+    mt19937_64 rng;
+    vector<double> cdf;
+    double escala = 0.0;
+    double escala_corta = 0.0;
+    double escala_larga = 0.0;
+};
+
+// --- Escritura por bloques ---
+
+class Salida {
+public:
+    Salida(ostream& destino) : destino(destino), buffer(TAMANO_BUFFER) {}
+
+    void Corrida(uint8_t valor, uint64_t n) {
+        while (n > 0) {
+            size_t k = (size_t)min<uint64_t>(n, buffer.size() - usado);
+            memset(buffer.data() + usado, valor, k);
+            Avanzar(k);
+            n -= k;
+        }
+    }
+
+    void Aleatorios(Generador& generador, uint64_t n, int anterior) {
+        bool primero = true;
+        while (n > 0) {
+            size_t k = (size_t)min<uint64_t>(n, buffer.size() - usado);
+            generador.Bytes_Aleatorios(buffer.data() + usado, k);
+            // El primer byte no continúa la corrida anterior
+            if (primero && (int)buffer[usado] == anterior) buffer[usado] ^= 1;
+            primero = false;
+            Avanzar(k);
+            n -= k;
+        }
+    }
+
+    uint8_t Ultimo() const {
+        return buffer[(usado + buffer.size() - 1) % buffer.size()];
+    }
+
+    bool Terminar() {
+        Vaciar();
+        destino.flush();
+        return (bool)destino;
+    }
+
+private:
+    void Avanzar(size_t k) {
+        usado += k;
+        if (usado == buffer.size()) Vaciar();
+    }
+
+    void Vaciar() {
+        if (usado > 0) destino.write((const char*)buffer.data(), (streamsize)usado);
+        usado = 0;
+    }
+
+    ostream& destino;
+    vector<uint8_t> buffer;
+    size_t usado = 0;
+};
+
+struct Estadisticas {
+    uint64_t corridas = 0;
+    uint64_t bytes_corridas = 0;
+    uint64_t bytes_bandera = 0;
+    uint64_t bytes_aleatorios = 0;
+    uint64_t corridas_largas = 0;      // > 255 bytes: el códec rle las parte en varias tuplas
+    uint64_t fronteras = 0;
+    uint64_t fronteras_cruzadas = 0;
+};
+
+// Offsets donde empiezan los ranks 1..P-1 en Calcular_Particion para cada P pedido
+static vector<uint64_t> Calcular_Fronteras(uint64_t total, const vector<int>& procesos) {
+    vector<uint64_t> fronteras;
+    for (int p : procesos) {
+        for (int r = 1; r < p; ++r) {
+            uint64_t offset, longitud;
+            RLECompressor::Calcular_Particion(total, r, p, offset, longitud);
+            if (offset > 0 && offset < total) fronteras.push_back(offset);
+        }
+    }
+    sort(fronteras.begin(), fronteras.end());
+    fronteras.erase(unique(fronteras.begin(), fronteras.end()), fronteras.end());
+    return fronteras;
+}
+
+static void Generar(const Configuracion& config, Salida& salida, Estadisticas& estadisticas) {
+    Generador generador(config);
+    vector<uint64_t> fronteras = Calcular_Fronteras(config.tamano, config.procesos);
+    estadisticas.fronteras = fronteras.size();
+    size_t siguiente = 0;
+    uint64_t mitad = config.longitud_frontera / 2;
+
+    uint64_t pos = 0;
+    uint64_t fin_region = 0;
+    bool aleatoria = false;
+    int anterior = -1;
+
+    auto emitir_corrida = [&](uint64_t n) {
+        uint8_t valor = generador.Valor(anterior);
+        salida.Corrida(valor, n);
+        estadisticas.corridas++;
+        estadisticas.bytes_corridas += n;
+        if (valor >= 0xFE) estadisticas.bytes_bandera += n;
+        if (n > 255) estadisticas.corridas_largas++;
+        anterior = valor;
+        pos += n;
+    };
+
+    while (pos < config.tamano) {
+        if (pos >= fin_region) {
+            fin_region = min(config.tamano, pos + config.region);
+            aleatoria = generador.Region_Aleatoria();
+        }
+        uint64_t limite = fin_region;
+
+        // Corrida forzada centrada en la siguiente frontera; ignora el tipo de región
+        if (siguiente < fronteras.size()) {
+            uint64_t inicio = fronteras[siguiente] > mitad ? fronteras[siguiente] - mitad : 0;
+            if (pos >= inicio) {
+                uint64_t fin = min(config.tamano, max(pos + 1, inicio + config.longitud_frontera));
+                emitir_corrida(fin - pos);
+                while (siguiente < fronteras.size() && fronteras[siguiente] < pos) {
+                    estadisticas.fronteras_cruzadas++;
+                    siguiente++;
+                }
+                continue;
+            }
+            limite = min(limite, inicio);
+        }
+
+        if (aleatoria) {
+            uint64_t n = limite - pos;
+            salida.Aleatorios(generador, n, anterior);
+            estadisticas.bytes_aleatorios += n;
+            pos += n;
+            anterior = salida.Ultimo();
+            continue;
+        }
+
+        emitir_corrida(min(generador.Longitud(), limite - pos));
+    }
+}
+
+static void show_usage(const string& name) {
+    cerr << "Uso: " << name << " --output <file|-> [OPCIONES]" << endl
+         << "  --preset <nombre>   Forma predefinida: geometrica, zipf, bimodal, banderas, mixta, fronteras." << endl
+         << "                      Las demás opciones la modifican, sin importar el orden." << endl
+         << "  --size <N>[K|M|G|T] Tamaño del archivo (100M). Se escribe por bloques de 4 MiB." << endl
+         << "  --seed <N>          Semilla: las mismas opciones y semilla dan el mismo archivo (1)." << endl
+         << "  --runs <dist>       Longitud de las corridas (geometric:16):" << endl
+         << "                        geometric:<media>, fixed:<n>, zipf:<s>:<max> (P(k) ∝ 1/k^s, max <= 2^24)," << endl
+         << "                        bimodal:<media_corta>:<media_larga>:<prob_larga> (dos geométricas)." << endl
+         << "  --alphabet <N>      Valores de las corridas: bytes 0..N-1 (256)." << endl
+         << "  --flags <f>         Fracción de corridas de bytes bandera 0xFE/0xFF; el resto evita ambos." << endl
+         << "  --mix <f>:<MiB>     Regiones de <MiB> de bytes aleatorios con probabilidad f (incompresibles)." << endl
+         << "  --straddle <P,...>  Fuerza una corrida sobre cada frontera de Calcular_Particion para cada P." << endl
+         << "  --straddle-length <N> Longitud de esas corridas (300; más de 255 también parte el conteo)." << endl;
+}
+
+int main(int argc, char* argv[]) {
+    Configuracion config;
+
+    // El preset se aplica primero para que las opciones explícitas lo modifiquen
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (string(argv[i]) == "--preset" && !Aplicar_Preset(argv[i + 1], config)) {
+            cerr << "ERROR: Preset desconocido: " << argv[i + 1] << endl;
+            return 1;
+        }
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool valido = true;
+        if (arg == "--preset" && i + 1 < argc) {
+            ++i;
+        } else if (arg == "--size" && i + 1 < argc) {
+            valido = Leer_Tamano(argv[++i], config.tamano);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            config.semilla = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--output" && i + 1 < argc) {
+            config.salida = argv[++i];
+        } else if (arg == "--runs" && i + 1 < argc) {
+            valido = Leer_Distribucion(argv[++i], config);
+        } else if (arg == "--alphabet" && i + 1 < argc) {
+            config.alfabeto = atoi(argv[++i]);
+            valido = config.alfabeto >= 1 && config.alfabeto <= 256;
+        } else if (arg == "--flags" && i + 1 < argc) {
+            config.banderas = atof(argv[++i]);
+            valido = config.banderas >= 0.0 && config.banderas <= 1.0;
+        } else if (arg == "--mix" && i + 1 < argc) {
+            vector<string> partes = Separar(argv[++i], ':');
+            valido = partes.size() == 2;
+            if (valido) {
+                config.fraccion_aleatoria = atof(partes[0].c_str());
+                config.region = (uint64_t)max(1L, atol(partes[1].c_str())) << 20;
+                valido = config.fraccion_aleatoria >= 0.0 && config.fraccion_aleatoria <= 1.0;
+            }
+        } else if (arg == "--straddle" && i + 1 < argc) {
+            config.procesos.clear();
+            for (const string& p : Separar(argv[++i], ',')) {
+                int n = atoi(p.c_str());
+                if (n < 2) valido = false;
+                config.procesos.push_back(n);
+            }
+        } else if (arg == "--straddle-length" && i + 1 < argc) {
+            config.longitud_frontera = (uint64_t)max(1L, atol(argv[++i]));
+        } else {
+            show_usage(argv[0]);
+            return 1;
+        }
+        if (!valido) {
+            cerr << "ERROR: Valor inválido para " << arg << ": " << argv[i] << endl;
+            return 1;
+        }
+    }
+
+    if (config.salida.empty()) {
+        show_usage(argv[0]);
+        return 1;
+    }
+
+    bool a_stdout = (config.salida == "-");
+    ofstream archivo;
+    if (!a_stdout) {
+        archivo.open(config.salida, ios::binary | ios::trunc);
+        if (!archivo) {
+            cerr << "ERROR: No se pudo crear el archivo de salida: " << config.salida << endl;
+            return 1;
+        }
+    }
+    // Con la salida en stdout el resumen va a stderr
+    ostream& resumen = a_stdout ? cerr : cout;
+
+    auto inicio = chrono::steady_clock::now();
+    Salida salida(a_stdout ? cout : archivo);
+    Estadisticas estadisticas;
+    Generar(config, salida, estadisticas);
+    if (!salida.Terminar()) {
+        cerr << "ERROR: Falló la escritura de " << config.salida << endl;
+        return 1;
+    }
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    double total = (double)max<uint64_t>(config.tamano, 1);
+    resumen << fixed << setprecision(3)
+            << "Archivo: " << config.salida << endl
+            << "  Tamaño: " << config.tamano << " B (semilla " << config.semilla << ")" << endl
+            << "  Corridas: " << estadisticas.corridas << ", longitud media "
+            << (estadisticas.corridas ? (double)estadisticas.bytes_corridas / estadisticas.corridas : 0.0)
+            << " B, " << estadisticas.corridas_largas << " de más de 255 B" << endl
+            << "  Bytes bandera (0xFE/0xFF) en corridas: " << 100.0 * estadisticas.bytes_bandera / total << " %" << endl
+            << "  Bytes aleatorios (regiones incompresibles): " << 100.0 * estadisticas.bytes_aleatorios / total << " %" << endl
+            << "  Fronteras cruzadas: " << estadisticas.fronteras_cruzadas << " de " << estadisticas.fronteras << endl
+            << "  Tiempo: " << segundos << " s (" << (total / 1e6) / max(segundos, 1e-9) << " MB/s)" << endl;
+    return 0;
+}
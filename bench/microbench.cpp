@@ -0,0 +1,500 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+
+/**
+ * Micro-benchmarks de los códecs dentro del proceso (make microbench).
+ *
+ * Mide Comprimir_Local, Descomprimir_Local (versiones sobre buffers del llamador) y
+ * Corregir_Fronteras sobre una matriz de tamaños (4 KiB a 1 GiB) y formas de datos, sin el
+ * arranque de mpirun, MPI_Init ni la E/S de archivos que mezcla el "Tiempo:" de run_benchmarks.sh.
+ * Cada caso se calienta, calibra sus iteraciones para durar al menos --min-time y se repite
+ * --repetitions veces; se reportan la mediana, el promedio, la desviación y el mínimo.
+ *
+ * Los códecs corren solo en el rank 0; Corregir_Fronteras es colectiva y la ejecutan todos los
+ * procesos (con un solo proceso no hay fronteras que corregir y se omite).
+ */
+
+#include "../include/RLECompressor.hpp"
+#include "../include/RLEKernels.hpp"
+#include <mpi.h>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+using namespace std;
+
+// --- Conteo de asignaciones: reemplaza el operator new global de este ejecutable ---
+
+static atomic<uint64_t> asignaciones{0};
+static atomic<uint64_t> bytes_asignados{0};
+
+void* operator new(size_t n) {
+    asignaciones.fetch_add(1, memory_order_relaxed);
+    bytes_asignados.fetch_add(n, memory_order_relaxed);
+    void* p = malloc(n > 0 ? n : 1);
+    if (!p) throw bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// --- Ciclos: contador de hardware del proceso (perf_event_open) o, si el kernel no lo permite, el TSC ---
+
+class ContadorCiclos {
+public:
+    ContadorCiclos() {
+        perf_event_attr atributos;
+        memset(&atributos, 0, sizeof(atributos));
+        atributos.type = PERF_TYPE_HARDWARE;
+        atributos.size = sizeof(atributos);
+        atributos.config = PERF_COUNT_HW_CPU_CYCLES;
+        atributos.exclude_kernel = 1;
+        atributos.exclude_hv = 1;
+        fd = (int)syscall(__NR_perf_event_open, &atributos, 0, -1, -1, 0);
+    }
+
+    ~ContadorCiclos() {
+        if (fd >= 0) close(fd);
+    }
+
+    uint64_t Leer() const {
+        uint64_t ciclos = 0;
+        if (fd >= 0 && read(fd, &ciclos, sizeof(ciclos)) == (ssize_t)sizeof(ciclos)) return ciclos;
+#if defined(__x86_64__)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    // "perf" (ciclos del núcleo), "tsc" (ciclos de referencia, no siguen la frecuencia real) o "n/d"
+    const char* Fuente() const {
+#if defined(__x86_64__)
+        return fd >= 0 ? "perf" : "tsc";
+#else
+        return fd >= 0 ? "perf" : "n/d";
+#endif
+    }
+
+private:
+    int fd = -1;
+};
+
+static ContadorCiclos contador_ciclos;
+
+// --- Configuración ---
+
+struct Configuracion {
+    uint64_t tamano_maximo = (uint64_t)1 << 30;  // --max-size (MiB)
+    double tiempo_minimo = 0.2;                  // --min-time: segundos medidos por repetición
+    double calentamiento = 0.05;                 // --warmup: segundos de calentamiento
+    int repeticiones = 5;                        // --repetitions
+    string filtro;                               // --filter: subcadena del nombre del caso
+    string salida;                               // --output: JSON (.json) o CSV
+};
+
+// Formas de datos: mismas familias que generate_test_data.sh más corridas de longitud geométrica y
+// bytes bandera frecuentes (que el códec rle escapa)
+enum class Forma { Plana, Aleatoria, Malla, Corridas, Banderas };
+static const Forma FORMAS[] = {Forma::Plana, Forma::Aleatoria, Forma::Malla, Forma::Corridas, Forma::Banderas};
+
+static const char* Nombre_Forma(Forma forma) {
+    switch (forma) {
+        case Forma::Plana: return "plana";
+        case Forma::Aleatoria: return "aleatoria";
+        case Forma::Malla: return "malla";
+        case Forma::Corridas: return "corridas";
+        case Forma::Banderas: return "banderas";
+    }
+    return "?";
+}
+
+static vector<uint8_t> Generar_Forma(Forma forma, size_t n) {
+    vector<uint8_t> datos(n);
+    uint64_t semilla = 0x9E3779B97F4A7C15ULL;
+    auto siguiente = [&]() {
+        semilla = semilla * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (uint32_t)(semilla >> 33);
+    };
+    size_t i = 0;
+    switch (forma) {
+        case Forma::Plana:
+            memset(datos.data(), 'A', n);
+            break;
+        case Forma::Aleatoria:
+            for (; i < n; ++i) datos[i] = (uint8_t)siguiente();
+            break;
+        case Forma::Malla:
+            for (; i < n; ++i) datos[i] = (uint8_t)('0' + i % 10);
+            break;
+        case Forma::Corridas:
+            // Longitud geométrica de media ~16: cada byte termina la corrida con probabilidad 1/16
+            while (i < n) {
+                uint8_t valor = (uint8_t)siguiente();
+                do {
+                    datos[i++] = valor;
+                } while (i < n && siguiente() % 16 != 0);
+            }
+            break;
+        case Forma::Banderas:
+            // Un cuarto de los bytes son 0xFE o 0xFF
+            for (; i < n; ++i) {
+                uint32_t r = siguiente();
+                datos[i] = (r % 4 == 0) ? (uint8_t)(0xFE | ((r >> 2) & 1)) : (uint8_t)(r >> 8);
+            }
+            break;
+    }
+    return datos;
+}
+
+static const char* Nombre_Codec(uint8_t codec) {
+    switch (codec) {
+        case RLEContainer::CODEC_RLE: return "rle";
+        case RLEContainer::CODEC_RLE_VARINT: return "varint";
+        case RLEContainer::CODEC_RLE_LITERALES: return "literal";
+    }
+    return "?";
+}
+
+static string Nombre_Tamano(uint64_t n) {
+    if (n >= ((uint64_t)1 << 30) && n % ((uint64_t)1 << 30) == 0) return to_string(n >> 30) + "GiB";
+    if (n >= ((uint64_t)1 << 20) && n % ((uint64_t)1 << 20) == 0) return to_string(n >> 20) + "MiB";
+    if (n >= 1024 && n % 1024 == 0) return to_string(n >> 10) + "KiB";
+    return to_string(n) + "B";
+}
+
+// --- Medición ---
+
+struct Resultado {
+    string nombre;
+    uint64_t bytes = 0;         // Bytes de entrada por iteración
+    uint64_t iteraciones = 0;   // Iteraciones por repetición
+    vector<double> ns;          // ns por iteración de cada repetición
+    double ciclos = 0;          // Ciclos por iteración (mediana de las repeticiones)
+    double asignaciones = 0;    // Asignaciones por iteración
+    double bytes_asignados = 0; // Bytes asignados por iteración
+    uint64_t bytes_salida = 0;  // Bytes que produce una iteración (informativo)
+};
+
+struct Estadisticas {
+    double media = 0, mediana = 0, desviacion = 0, minimo = 0;
+};
+
+static Estadisticas Calcular_Estadisticas(vector<double> valores) {
+    Estadisticas e;
+    if (valores.empty()) return e;
+    sort(valores.begin(), valores.end());
+    size_t n = valores.size();
+    e.minimo = valores[0];
+    e.mediana = (n % 2) ? valores[n / 2] : (valores[n / 2 - 1] + valores[n / 2]) / 2;
+    for (double v : valores) e.media += v;
+    e.media /= n;
+    for (double v : valores) e.desviacion += (v - e.media) * (v - e.media);
+    e.desviacion = (n > 1) ? sqrt(e.desviacion / (n - 1)) : 0;
+    return e;
+}
+
+static double Segundos_Desde(chrono::steady_clock::time_point inicio) {
+    return chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+/**
+ * Mide `operar` al estilo de google-benchmark. Sin `preparar` las iteraciones se cronometran en
+ * lote; con `preparar` (que restaura el estado de entrada, p. ej. la salida que Corregir_Fronteras
+ * modifica) cada iteración se cronometra sola y la preparación queda fuera de la medición.
+ * Todos los procesos de `comm` ejecutan las mismas iteraciones: se calibran con el máximo entre
+ * procesos y cada repetición cuenta el tiempo del proceso más lento.
+ */
+static Resultado Medir(const string& nombre, uint64_t bytes, const Configuracion& config, MPI_Comm comm,
+                       const function<void()>& operar, const function<void()>& preparar = nullptr) {
+    Resultado r;
+    r.nombre = nombre;
+    r.bytes = bytes;
+
+    // Devuelve los segundos de `n` iteraciones (sin la preparación)
+    auto ejecutar = [&](uint64_t n) {
+        double total = 0;
+        if (preparar) {
+            for (uint64_t k = 0; k < n; ++k) {
+                preparar();
+                auto inicio = chrono::steady_clock::now();
+                operar();
+                total += Segundos_Desde(inicio);
+            }
+        } else {
+            auto inicio = chrono::steady_clock::now();
+            for (uint64_t k = 0; k < n; ++k) operar();
+            total = Segundos_Desde(inicio);
+        }
+        return total;
+    };
+
+    // Calibración: lotes crecientes hasta que uno dure al menos una décima de --min-time (el primero
+    // también toca las páginas de los buffers). El máximo entre procesos mantiene iguales los lotes.
+    uint64_t lote = 1;
+    double segundos_lote;
+    while (true) {
+        segundos_lote = ejecutar(lote);
+        MPI_Allreduce(MPI_IN_PLACE, &segundos_lote, 1, MPI_DOUBLE, MPI_MAX, comm);
+        if (segundos_lote >= config.tiempo_minimo / 10 || lote >= 1000000000) break;
+        lote *= (uint64_t)max(2.0, min(10.0, config.tiempo_minimo / 10 / max(segundos_lote, 1e-9)));
+    }
+    double por_iteracion = max(segundos_lote / lote, 1e-9);
+    ejecutar((uint64_t)min(1e6, config.calentamiento / por_iteracion));
+    r.iteraciones = (uint64_t)max(1.0, min(1e9, ceil(config.tiempo_minimo / por_iteracion)));
+
+    vector<double> ciclos;
+    for (int rep = 0; rep < config.repeticiones; ++rep) {
+        MPI_Barrier(comm);
+        uint64_t asignaciones_inicio = asignaciones.load(), bytes_inicio = bytes_asignados.load();
+        uint64_t ciclos_inicio = contador_ciclos.Leer();
+        double segundos = ejecutar(r.iteraciones);
+        uint64_t ciclos_fin = contador_ciclos.Leer();
+        r.asignaciones = (double)(asignaciones.load() - asignaciones_inicio) / r.iteraciones;
+        r.bytes_asignados = (double)(bytes_asignados.load() - bytes_inicio) / r.iteraciones;
+
+        MPI_Allreduce(MPI_IN_PLACE, &segundos, 1, MPI_DOUBLE, MPI_MAX, comm);
+        r.ns.push_back(segundos * 1e9 / r.iteraciones);
+        ciclos.push_back((double)(ciclos_fin - ciclos_inicio) / r.iteraciones);
+    }
+    r.ciclos = Calcular_Estadisticas(ciclos).mediana;
+    return r;
+}
+
+static bool Seleccionado(const Configuracion& config, const string& nombre) {
+    return config.filtro.empty() || nombre.find(config.filtro) != string::npos;
+}
+
+static void Imprimir_Encabezado() {
+    cout << left << setw(46) << "Caso" << right
+         << setw(12) << "Iter."
+         << setw(14) << "ns/iter"
+         << setw(10) << "ns/B"
+         << setw(10) << "GB/s"
+         << setw(16) << (string("ciclos/B(") + contador_ciclos.Fuente() + ")")
+         << setw(10) << "asig."
+         << setw(8) << "CV%" << endl;
+    cout << string(126, '-') << endl;
+}
+
+static void Imprimir_Resultado(const Resultado& r) {
+    Estadisticas e = Calcular_Estadisticas(r.ns);
+    double ns_byte = e.mediana / max<uint64_t>(r.bytes, 1);
+    cout << left << setw(46) << r.nombre << right << fixed
+         << setw(12) << r.iteraciones
+         << setw(14) << setprecision(0) << e.mediana
+         << setw(10) << setprecision(4) << ns_byte
+         << setw(10) << setprecision(3) << (ns_byte > 0 ? 1.0 / ns_byte : 0)
+         << setw(16) << setprecision(3) << r.ciclos / max<uint64_t>(r.bytes, 1)
+         << setw(10) << setprecision(1) << r.asignaciones
+         << setw(8) << setprecision(1) << (e.media > 0 ? 100 * e.desviacion / e.media : 0) << endl;
+}
+
+// JSON si `archivo` termina en ".json", CSV en otro caso (misma convención que --metrics)
+static bool Escribir_Resultados(const string& archivo, const vector<Resultado>& resultados, const Configuracion& config, const char* fuente_ciclos) {
+    ofstream os(archivo);
+    if (!os.is_open()) return false;
+    bool json = archivo.size() >= 5 && archivo.compare(archivo.size() - 5, 5, ".json") == 0;
+    os << setprecision(9);
+
+    if (json) {
+        os << "{\n  \"repeticiones\": " << config.repeticiones << ",\n  \"tiempo_minimo_s\": " << config.tiempo_minimo
+           << ",\n  \"fuente_ciclos\": \"" << fuente_ciclos << "\",\n  \"casos\": [\n";
+    } else {
+        os << "caso,bytes,iteraciones,ns_mediana,ns_media,ns_desviacion,ns_minimo,ns_por_byte,gb_s,ciclos_por_byte,asignaciones,bytes_asignados,bytes_salida" << endl;
+    }
+    for (size_t i = 0; i < resultados.size(); ++i) {
+        const Resultado& r = resultados[i];
+        Estadisticas e = Calcular_Estadisticas(r.ns);
+        double ns_byte = e.mediana / max<uint64_t>(r.bytes, 1);
+        double gb_s = ns_byte > 0 ? 1.0 / ns_byte : 0;
+        double ciclos_byte = r.ciclos / max<uint64_t>(r.bytes, 1);
+        if (json) {
+            os << "    {\"caso\": \"" << r.nombre << "\", \"bytes\": " << r.bytes << ", \"iteraciones\": " << r.iteraciones
+               << ", \"ns_mediana\": " << e.mediana << ", \"ns_media\": " << e.media << ", \"ns_desviacion\": " << e.desviacion
+               << ", \"ns_minimo\": " << e.minimo << ", \"ns_por_byte\": " << ns_byte << ", \"gb_s\": " << gb_s
+               << ", \"ciclos_por_byte\": " << ciclos_byte << ", \"asignaciones\": " << r.asignaciones
+               << ", \"bytes_asignados\": " << r.bytes_asignados << ", \"bytes_salida\": " << r.bytes_salida << "}"
+               << (i + 1 < resultados.size() ? "," : "") << "\n";
+        } else {
+            os << r.nombre << "," << r.bytes << "," << r.iteraciones << "," << e.mediana << "," << e.media << "," << e.desviacion
+               << "," << e.minimo << "," << ns_byte << "," << gb_s << "," << ciclos_byte << "," << r.asignaciones
+               << "," << r.bytes_asignados << "," << r.bytes_salida << endl;
+        }
+    }
+    if (json) os << "  ]\n}\n";
+    return (bool)os;
+}
+
+// Espera a los demás procesos sin ocupar un núcleo mientras el rank 0 mide los códecs
+static void Esperar_Sin_Ocupar(MPI_Comm comm) {
+    MPI_Request peticion;
+    MPI_Ibarrier(comm, &peticion);
+    int listo = 0;
+    while (!listo) {
+        MPI_Test(&peticion, &listo, MPI_STATUS_IGNORE);
+        if (!listo) usleep(1000);
+    }
+}
+
+static void show_usage(const string& name) {
+    cerr << "Uso: mpirun -np <P> " << name << " [OPCIONES]" << endl
+         << "  --max-size <MiB>    Tamaño máximo de la matriz 4 KiB, 64 KiB, 1 MiB, 16 MiB, 256 MiB, 1 GiB (1024)." << endl
+         << "  --min-time <s>      Tiempo mínimo medido por repetición (0.2)." << endl
+         << "  --warmup <s>        Tiempo de calentamiento por caso (0.05)." << endl
+         << "  --repetitions <N>   Repeticiones por caso para las estadísticas (5)." << endl
+         << "  --filter <texto>    Solo los casos cuyo nombre contiene el texto (p. ej. Descomprimir_Local/varint)." << endl
+         << "  --output <file>     Escribe todos los resultados en JSON (.json) o CSV." << endl;
+}
+
+int main(int argc, char* argv[]) {
+    MPI_Init(&argc, &argv);
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    Configuracion config;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--max-size" && i + 1 < argc) {
+            config.tamano_maximo = (uint64_t)max(1L, atol(argv[++i])) << 20;
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            config.tiempo_minimo = max(1e-3, atof(argv[++i]));
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            config.calentamiento = max(0.0, atof(argv[++i]));
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            config.repeticiones = max(1, atoi(argv[++i]));
+        } else if (arg == "--filter" && i + 1 < argc) {
+            config.filtro = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            config.salida = argv[++i];
+        } else {
+            if (rank == 0) show_usage(argv[0]);
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    vector<uint64_t> tamanos;
+    for (uint64_t n = 4096; n <= ((uint64_t)1 << 30); n *= 16) {
+        if (n <= config.tamano_maximo) tamanos.push_back(n);
+    }
+    if (tamanos.empty() || tamanos.back() < config.tamano_maximo) tamanos.push_back(min<uint64_t>(config.tamano_maximo, (uint64_t)1 << 30));
+    const uint8_t CODECS[] = {RLEContainer::CODEC_RLE, RLEContainer::CODEC_RLE_VARINT, RLEContainer::CODEC_RLE_LITERALES};
+
+    vector<Resultado> resultados;
+    if (rank == 0) {
+        cout << "--- MICRO-BENCHMARKS DE LOS CÓDECS (" << RLEKernels::Nombre(RLEKernels::Implementacion_Activa())
+             << ", " << config.repeticiones << " repeticiones, mediana) ---" << endl;
+        Imprimir_Encabezado();
+    }
+
+    // Códecs: solo el rank 0, sin MPI en la medición
+    if (rank == 0) {
+        for (Forma forma : FORMAS) {
+            vector<uint8_t> datos = Generar_Forma(forma, tamanos.back());
+            vector<uint8_t> comprimido, descomprimido(tamanos.back());
+            for (uint8_t codec : CODECS) {
+                comprimido.resize(RLECompressor::MaxCompressedSize(tamanos.back(), codec));
+                for (uint64_t n : tamanos) {
+                    string sufijo = string("/") + Nombre_Codec(codec) + "/" + Nombre_Forma(forma) + "/" + Nombre_Tamano(n);
+                    size_t longitud_comprimida = RLECompressor::Comprimir_Local(datos.data(), n, comprimido.data(), comprimido.size(), codec);
+
+                    string nombre = "Comprimir_Local" + sufijo;
+                    if (Seleccionado(config, nombre)) {
+                        Resultado r = Medir(nombre, n, config, MPI_COMM_SELF, [&]() {
+                            RLECompressor::Comprimir_Local(datos.data(), n, comprimido.data(), comprimido.size(), codec);
+                        });
+                        r.bytes_salida = longitud_comprimida;
+                        Imprimir_Resultado(r);
+                        resultados.push_back(r);
+                    }
+
+                    // Los bytes por iteración son los descomprimidos, para comparar con la compresión
+                    nombre = "Descomprimir_Local" + sufijo;
+                    if (Seleccionado(config, nombre)) {
+                        Resultado r = Medir(nombre, n, config, MPI_COMM_SELF, [&]() {
+                            RLECompressor::Descomprimir_Local(comprimido.data(), longitud_comprimida, descomprimido.data(), n, codec);
+                        });
+                        r.bytes_salida = n;
+                        if (memcmp(descomprimido.data(), datos.data(), n) != 0) {
+                            cerr << "ERROR: " << nombre << " no reproduce la entrada." << endl;
+                            MPI_Abort(MPI_COMM_WORLD, 1);
+                        }
+                        Imprimir_Resultado(r);
+                        resultados.push_back(r);
+                    }
+                }
+            }
+        }
+    }
+    Esperar_Sin_Ocupar(MPI_COMM_WORLD);
+
+    // Corregir_Fronteras: colectiva (intercambio de resúmenes y corrección local). Cada proceso
+    // comprime el mismo tramo, así que en "plana" toda corrida cruza procesos. Se limita a 16 MiB:
+    // el costo no depende del tamaño y cada iteración restaura la salida local fuera de la medición.
+    if (size > 1) {
+        for (Forma forma : FORMAS) {
+            uint64_t maximo = min<uint64_t>(tamanos.back(), (uint64_t)16 << 20);
+            vector<uint8_t> datos = Generar_Forma(forma, maximo);
+            for (uint8_t codec : {RLEContainer::CODEC_RLE, RLEContainer::CODEC_RLE_VARINT}) {
+                for (uint64_t n : tamanos) {
+                    if (n > maximo) break;
+                    string nombre = string("Corregir_Fronteras/") + Nombre_Codec(codec) + "/" + Nombre_Forma(forma) + "/" + Nombre_Tamano(n)
+                                  + "/P" + to_string(size);
+                    if (!Seleccionado(config, nombre)) continue;
+
+                    vector<uint8_t> original(RLECompressor::MaxCompressedSize(n, codec));
+                    original.resize(RLECompressor::Comprimir_Local(datos.data(), n, original.data(), original.size(), codec));
+                    RLECompressor::Frontera frontera;
+                    RLECompressor::Actualizar_Frontera(frontera, datos.data(), n);
+                    vector<uint8_t> salida;
+                    salida.reserve(original.size() + RLECompressor::MAX_CIERRE_CORRIDA * 2);
+
+                    Resultado r = Medir(nombre, n, config, MPI_COMM_WORLD,
+                        [&]() { RLECompressor::Corregir_Fronteras(salida, frontera, rank, size, codec); },
+                        [&]() { salida.assign(original.begin(), original.end()); });
+                    r.bytes_salida = salida.size();
+                    if (rank == 0) {
+                        Imprimir_Resultado(r);
+                        resultados.push_back(r);
+                    }
+                }
+            }
+        }
+    } else if (rank == 0) {
+        cout << "(Corregir_Fronteras se omite con un solo proceso: ejecute con mpirun -np 2 o más)" << endl;
+    }
+
+    if (rank == 0 && !config.salida.empty()) {
+        if (Escribir_Resultados(config.salida, resultados, config, contador_ciclos.Fuente())) {
+            cout << "Resultados escritos en: " << config.salida << endl;
+        } else {
+            cerr << "ERROR: No se pudo escribir el archivo de resultados: " << config.salida << endl;
+        }
+    }
+
+    MPI_Finalize();
+    return 0;
+}
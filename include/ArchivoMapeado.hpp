@@ -0,0 +1,44 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+#ifndef ARCHIVO_MAPEADO_HPP
+#define ARCHIVO_MAPEADO_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Archivo de entrada proyectado en memoria (mmap) de solo lectura.
+ *
+ * Las versiones secuenciales leen directamente de la proyección, sin copiar el archivo a un
+ * buffer propio. Se indica al núcleo que el acceso es secuencial (MADV_SEQUENTIAL) y, donde
+ * exista, que puede usar páginas grandes (MADV_HUGEPAGE).
+ */
+class ArchivoMapeado {
+public:
+    ArchivoMapeado() = default;
+    ~ArchivoMapeado();
+
+    ArchivoMapeado(const ArchivoMapeado&) = delete;
+    ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+
+    /**
+     * @brief Proyecta el archivo completo. Un archivo vacío es válido (Datos() es nulo).
+     * @return false si no se pudo abrir o proyectar.
+     */
+    bool Abrir(const std::string& ruta);
+
+    void Cerrar();
+
+    const uint8_t* Datos() const { return datos; }
+    size_t Longitud() const { return longitud; }
+
+private:
+    uint8_t* datos = nullptr;
+    size_t longitud = 0;
+};
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+#ifndef METRICAS_HPP
+#define METRICAS_HPP
+
+#include <string>
+#include <cstdint>
+#include <mpi.h>
+
+/**
+ * @brief Fases en las que se divide el tiempo de las funciones Run*.
+ */
+enum class Fase {
+    Lectura,       // Lectura de la entrada (tiempo de espera no solapado con el cómputo)
+    Codificacion,  // Compresión o descompresión local
+    Fronteras,     // Intercambio entre procesos: corrección de fronteras, índice y offsets
+    Escritura,     // Recolección y escritura de la salida
+    Total
+};
+
+/**
+ * @brief Tiempos y bytes por fase de un proceso.
+ *
+ * Cada proceso acumula sus mediciones; Reducir_Y_Escribir las reduce (mínimo, máximo y promedio)
+ * en el rank 0 y escribe el resultado en JSON o CSV (--metrics), junto con la memoria residente
+ * pico de cada proceso.
+ */
+class Metricas {
+public:
+    static constexpr int NUM_FASES = 5;
+
+    /**
+     * @brief Acumula `segundos` y `bytes` procesados en la fase.
+     */
+    void Registrar(Fase fase, double segundos, uint64_t bytes);
+
+    double Tiempo(Fase fase) const { return tiempos[(int)fase]; }
+    uint64_t Bytes(Fase fase) const { return bytes[(int)fase]; }
+
+    /**
+     * @brief Reduce las métricas de todos los procesos de `comm` en su rank 0, que las escribe en
+     * `archivo`: JSON si termina en ".json", CSV en otro caso. Es colectiva en `comm`.
+     * @return false (en el rank 0) si no se pudo escribir el archivo.
+     */
+    bool Reducir_Y_Escribir(const std::string& archivo, const std::string& operacion, const std::string& modo, int hilos, MPI_Comm comm) const;
+
+    static const char* Nombre(Fase fase);
+
+    /**
+     * @brief Memoria residente pico del proceso en bytes (getrusage), 0 si no está disponible.
+     */
+    static uint64_t Memoria_Pico();
+
+private:
+    double tiempos[NUM_FASES] = {};
+    uint64_t bytes[NUM_FASES] = {};
+};
+
+#endif
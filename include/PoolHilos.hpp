@@ -0,0 +1,61 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+#ifndef POOL_HILOS_HPP
+#define POOL_HILOS_HPP
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/**
+ * @brief Conjunto fijo de hilos de trabajo dentro de un proceso MPI.
+ *
+ * Ejecuta lotes de tareas independientes (índices 0..n-1) repartidas dinámicamente entre los
+ * hilos; el hilo que llama también trabaja. Los hilos no realizan llamadas MPI, por lo que basta
+ * con MPI_THREAD_FUNNELED.
+ */
+class PoolHilos {
+public:
+    /**
+     * @param hilos Número total de hilos, incluido el que llama (1: ejecución en línea, sin hilos extra).
+     */
+    explicit PoolHilos(int hilos);
+    ~PoolHilos();
+
+    PoolHilos(const PoolHilos&) = delete;
+    PoolHilos& operator=(const PoolHilos&) = delete;
+
+    int Hilos() const { return hilos; }
+
+    /**
+     * @brief Ejecuta `tarea(i)` para i en [0, tareas) y espera a que terminen todas.
+     */
+    void Ejecutar(size_t tareas, const std::function<void(size_t)>& tarea);
+
+private:
+    void Trabajar();
+    void Consumir_Tareas();
+
+    int hilos;
+    std::vector<std::thread> trabajadores;
+
+    std::mutex candado;
+    std::condition_variable hay_lote;
+    std::condition_variable lote_terminado;
+
+    const std::function<void(size_t)>* tarea_actual = nullptr;
+    size_t total_tareas = 0;
+    std::atomic<size_t> siguiente_tarea{0};
+    size_t tareas_pendientes = 0;
+    unsigned long long generacion = 0;
+    bool terminar = false;
+};
+
+#endif
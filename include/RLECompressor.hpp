@@ -9,53 +9,383 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 #include <mpi.h>
+#include "RLEContainer.hpp"
+
+class PoolHilos;
+
+/**
+ * @brief Estrategia para escribir la salida de las versiones paralelas.
+ */
+enum class ModoEscritura {
+    Colectiva,  // Cada proceso escribe su tramo con MPI_File_write_at_all (predeterminado)
+    Gather      // MPI_Gatherv al rank 0, que escribe el archivo completo (para comparación)
+};
+
+/**
+ * @brief Opciones de ejecución de las funciones Run*.
+ */
+struct RLEOptions {
+    ModoEscritura escritura = ModoEscritura::Colectiva;
+    size_t ventana = (size_t)16 << 20;  // Bytes de entrada por ventana de compresión (--window)
+    int hilos = 1;                      // Hilos de trabajo por proceso (--threads)
+    bool entrada_mapeada = false;       // Versiones secuenciales: leer la entrada con mmap (--mmap)
+    bool salida_directa = false;        // Versiones secuenciales: escribir la salida con O_DIRECT (--direct)
+    std::string metricas;               // Archivo de métricas por fase, JSON o CSV (--metrics); vacío: sin métricas
+    bool balanceo = false;              // Compresión paralela: tramos equilibrados por costo estimado (--balance)
+    bool dinamico = false;              // Compresión paralela: trozos reclamados bajo demanda entre procesos (--dynamic)
+    size_t trozo_dinamico = (size_t)8 << 20;  // Bytes de entrada por trozo del reparto dinámico (--chunk)
+    uint8_t codec = RLEContainer::CODEC_RLE;  // Códec de la carga comprimida (--codec)
+    size_t elemento = 1;                // CODEC_RLE_ELEMENTOS: bytes por elemento (--element-size)
+    bool planos = false;                // CODEC_RLE_ELEMENTOS: transponer a planos de bytes (--transpose)
+    bool verificar = false;             // Descompresión: comprobar el CRC32C de cada bloque (--verify)
+    bool rango = false;                 // Descompresión: solo el rango de bytes del original (--range)
+    uint64_t rango_offset = 0;          // Inicio del rango en el archivo original
+    uint64_t rango_longitud = 0;        // Bytes del rango (se recorta al final del archivo)
+};
 
 /**
  * @brief Clase que contiene la lógica de la compresión y descompresión RLE
 */
 class RLECompressor {
 public:
+    /**
+     * @brief Tamaño objetivo (bytes descomprimidos) de cada bloque del contenedor.
+     */
+    static constexpr size_t TAMANO_BLOQUE = 1 << 20;
+
+    /**
+     * @brief Tamaño máximo de cada transferencia MPI. Los conteos de MPI son `int`, por lo que
+     * las lecturas, escrituras y recolecciones mayores se dividen en trozos de este tamaño.
+     */
+    static constexpr size_t TROZO_MAX_IO = (size_t)1 << 30;
+
+    /**
+     * @brief Valor de retorno de las funciones sobre buffers del llamador cuando la salida no cabe.
+     */
+    static constexpr size_t SIN_CAPACIDAD = SIZE_MAX;
+
+    /**
+     * @brief Bytes que puede emitir Cerrar_Corrida como máximo (una tupla con un conteo LEB128 de
+     * 64 bits: bandera, 10 bytes de conteo y valor).
+     */
+    static constexpr size_t MAX_CIERRE_CORRIDA = 12;
+
+    /**
+     * @brief Bytes máximos de un bloque de literales (CODEC_RLE_LITERALES): los tramos más largos se
+     * parten para que Dividir_En_Bloques pueda cortar cerca de TAMANO_BLOQUE.
+     */
+    static constexpr size_t MAX_BLOQUE_LITERALES = (size_t)64 << 10;
+
+    /**
+     * @brief Elementos que se transponen juntos a planos de bytes (CODEC_RLE_ELEMENTOS con planos).
+     */
+    static constexpr size_t ELEMENTOS_POR_GRUPO = (size_t)64 << 10;
+
+    /**
+     * @brief Bytes mínimos de entrada por parte en la compresión con hilos: por debajo de esto el
+     * costo de repartir supera al de comprimir.
+     */
+    static constexpr size_t TAMANO_MINIMO_PARTE = (size_t)64 << 10;
+
+    // Las funciones Run* devuelven false si la operación falló (el motivo ya se escribió en cerr);
+    // main lo traduce en el código de salida.
+
     /**
      * @brief Comprime un archivo RLE usando MPI (Paralelo).
      */
-    static void RunParallel(const std::string& input_file, const std::string& output_file, int rank, int size);
+    static bool RunParallel(const std::string& input_file, const std::string& output_file, int rank, int size, const RLEOptions& opciones = RLEOptions());
     
     /**
      * @brief Comprime un archivo RLE de forma normal (Secuencial).
      */
-    static void RunSequential(const std::string& input_file, const std::string& output_file);
+    static bool RunSequential(const std::string& input_file, const std::string& output_file, const RLEOptions& opciones = RLEOptions());
     
     /**
      * @brief Descomprime un archivo RLE usando MPI (Paralelo).
      */
-    static void RunParallelDecompress(const std::string& input_file, const std::string& output_file, int rank, int size);
+    static bool RunParallelDecompress(const std::string& input_file, const std::string& output_file, int rank, int size, const RLEOptions& opciones = RLEOptions());
     
     /**
      * @brief Descomprime un archivo RLE de forma normal (Secuencial).
      */
-    static void RunSequentialDecompress(const std::string& input_file, const std::string& output_file);
+    static bool RunSequentialDecompress(const std::string& input_file, const std::string& output_file, const RLEOptions& opciones = RLEOptions());
+
+    /**
+     * @brief Comprime por flujo: `input_file` u `output_file` pueden ser "-" (stdin/stdout).
+     * La entrada se lee con buffers acotados (opciones.ventana) y la corrida abierta pasa de una
+     * lectura a la siguiente; con literales y elementos solo se codifican ventanas completas, así que
+     * la salida es la de RunSequential. La cabecera se emite de inmediato y cada bloque al cerrarse.
+     * Como el tamaño no se conoce al escribir la cabecera, se marca con BANDERA_TAMANO_EN_INDICE.
+     */
+    static bool RunStreamCompress(const std::string& input_file, const std::string& output_file, const RLEOptions& opciones = RLEOptions());
+
+    /**
+     * @brief Descomprime por flujo un contenedor (`input_file` u `output_file` pueden ser "-"):
+     * recorre los registros en orden sin usar el índice, decodifica los bloques por lotes de
+     * opciones.hilos y escribe cada lote en cuanto termina. Al final valida el pie contra los bloques
+     * leídos. El formato heredado (sin registros) no se puede leer por flujo.
+     */
+    static bool RunStreamDecompress(const std::string& input_file, const std::string& output_file, const RLEOptions& opciones = RLEOptions());
+
+    /**
+     * @brief Descomprime solo un rango de bytes del original (opciones.rango_offset y rango_longitud)
+     * en `output_file`, con Descomprimir_Rango (--range, en un solo proceso).
+     */
+    static bool RunRangeDecompress(const std::string& input_file, const std::string& output_file, const RLEOptions& opciones = RLEOptions());
+
+    /**
+     * @brief Descomprime los bytes [offset, offset + longitud) del archivo original sin leer el resto.
+     * Solo se leen la cabecera, el pie y el índice del contenedor; la suma de las longitudes originales
+     * del índice da el offset descomprimido de cada bloque (una entrada por ~TAMANO_BLOQUE bytes), una
+     * búsqueda binaria ubica el primer bloque del rango y solo se leen y decodifican (repartidos entre
+     * `hilos`) los bloques que lo cubren. El rango se recorta al final del archivo original.
+     * @return false, con el error en cerr, si el archivo no es un contenedor (los .rle heredados no tienen
+     * índice), el rango empieza después del final o un bloque está corrupto.
+     */
+    static bool Descomprimir_Rango(const std::string& input_file, uint64_t offset, uint64_t longitud, std::vector<uint8_t>& salida,
+                                   bool verificar = false, int hilos = 1);
+
+    /**
+     * @brief Bytes que se comprimen de cada región para estimar su costo (Calcular_Particion_Balanceada).
+     */
+    static constexpr size_t TAMANO_MUESTRA = (size_t)64 << 10;
+
+    /**
+     * @brief Regiones muestreadas por proceso en Calcular_Particion_Balanceada.
+     */
+    static constexpr int REGIONES_POR_PROCESO = 32;
+
+    /**
+     * @brief Costo relativo de un byte comprimido frente a un byte de entrada. Medido con --metrics:
+     * escribir un byte de salida cuesta unas 3 veces lo que codificar un byte de entrada.
+     */
+    static constexpr double PESO_SALIDA = 3.0;
+
+    /**
+     * @brief Distancia máxima que se adelanta un corte para caer en un cambio de valor.
+     */
+    static constexpr size_t ALINEACION_CORTE = 4096;
+
+    /**
+     * @brief Tramos de los procesos y desbalance estimado (costo máximo / promedio) antes y después.
+     */
+    struct Particion {
+        std::vector<uint64_t> cortes;      // size + 1 offsets: el proceso r toma [cortes[r], cortes[r + 1])
+        double desbalance_uniforme = 1.0;  // Con Calcular_Particion (bytes iguales)
+        double desbalance_balanceado = 1.0;
+    };
+
+    /**
+     * @brief Corrida que queda abierta al final de una ventana de compresión por flujo.
+     */
+    struct Corrida {
+        uint8_t valor = 0;
+        size_t conteo = 0;  // 0: no hay corrida abierta
+        uint8_t codec = RLEContainer::CODEC_RLE;
+        size_t elemento = 1;  // CODEC_RLE_ELEMENTOS: bytes por elemento
+        bool planos = false;  // CODEC_RLE_ELEMENTOS: transponer a planos de bytes
+    };
+
+    /**
+     * @brief Indica si los literales de `codec` van en bloques [0xFE][longitud][bytes] (sin escapes).
+     * Estos códecs codifican cada segmento por separado y no continúan corridas entre segmentos.
+     */
+    static constexpr bool Literales_En_Bloques(uint8_t codec) {
+        return codec >= RLEContainer::CODEC_RLE_LITERALES;
+    }
+
+    /**
+     * @brief Longitud máxima de una tupla en `codec`: las corridas más largas se parten en varias.
+     */
+    static constexpr uint64_t Conteo_Maximo(uint8_t codec) {
+        return codec == RLEContainer::CODEC_RLE ? 255 : UINT64_MAX;
+    }
+
+    /**
+     * @brief Datos de las fronteras del tramo de un proceso que usa Corregir_Fronteras.
+     */
+    struct Frontera {
+        uint64_t longitud = 0;       // Bytes del tramo
+        uint8_t primer_byte = 0;
+        uint8_t ultimo_byte = 0;
+        uint64_t corrida_inicial = 0;  // Longitud de la corrida inicial
+        uint64_t corrida_final = 0;    // Longitud de la corrida final
+        uint32_t crc = 0;              // CRC32C de los bytes del tramo
+    };
 
     /**
      * @brief Realiza la compresión RLE en un bloque de datos local.
      */
-    static std::vector<uint8_t> Comprimir_Local(const std::vector<uint8_t>& buffer);
+    static std::vector<uint8_t> Comprimir_Local(const std::vector<uint8_t>& buffer, uint8_t codec = RLEContainer::CODEC_RLE,
+                                                size_t elemento = 1, bool planos = false);
+
+    /**
+     * @brief Cota superior del tamaño comprimido de `n` bytes: cada byte bandera (0xFE/0xFF)
+     * aislado se escapa y ocupa 2 bytes; las tuplas nunca son más largas que su corrida (en ningún códec).
+     * Con CODEC_RLE_LITERALES un bloque de m literales ocupa a lo más 2m + 1 bytes y cada tupla deja
+     * margen para la cabecera del bloque siguiente, así que basta un byte más; CODEC_RLE_ELEMENTOS
+     * puede partir un bloque más por cada grupo de planos.
+     */
+    static constexpr size_t MaxCompressedSize(size_t n, uint8_t codec = RLEContainer::CODEC_RLE) {
+        return 2 * n + (Literales_En_Bloques(codec) ? 1 + n / ELEMENTOS_POR_GRUPO : 0);
+    }
+
+    /**
+     * @brief Comprime `longitud` bytes de `entrada` directamente en `salida`, sin reservar memoria.
+     * @param capacidad Debe ser al menos MaxCompressedSize(longitud, codec).
+     * @return Bytes escritos, o SIN_CAPACIDAD (sin escribir nada) si la capacidad es menor.
+     */
+    static size_t Comprimir_Local(const uint8_t* entrada, size_t longitud, uint8_t* salida, size_t capacidad, uint8_t codec = RLEContainer::CODEC_RLE,
+                                  size_t elemento = 1, bool planos = false);
     
+    /**
+     * @brief Comprime una ventana de datos continuando la corrida abierta de la ventana anterior.
+     * La corrida final de la ventana queda abierta en `corrida` (ver Cerrar_Corrida). El códec es
+     * el de `corrida`. Con CODEC_RLE_LITERALES y CODEC_RLE_ELEMENTOS la ventana se codifica completa,
+     * sin dejar nada abierto (con elementos, los bytes finales que no completan uno van como literales).
+     */
+    static void Comprimir_Ventana(const uint8_t* datos, size_t longitud, Corrida& corrida, std::vector<uint8_t>& salida);
+
+    /**
+     * @brief Versión sobre un buffer del llamador con al menos MaxCompressedSize(longitud) + MAX_CIERRE_CORRIDA bytes.
+     * @return Bytes escritos.
+     */
+    static size_t Comprimir_Ventana(const uint8_t* datos, size_t longitud, Corrida& corrida, uint8_t* salida);
+
+    /**
+     * @brief Comprime una ventana repartiéndola en partes que comprimen los hilos de `pool`.
+     * Las partes se unen en orden continuando la corrida de la anterior, por lo que la salida es
+     * idéntica a la de Comprimir_Ventana (salvo con Literales_En_Bloques, donde cada parte se codifica
+     * por separado y la salida sigue siendo válida pero no canónica). `parciales` guarda las salidas de cada parte y puede
+     * reutilizarse entre ventanas.
+     */
+    static void Comprimir_Ventana_Paralela(PoolHilos& pool, const uint8_t* datos, size_t longitud, Corrida& corrida,
+                                           std::vector<uint8_t>& salida, std::vector<std::vector<uint8_t>>& parciales);
+
+    /**
+     * @brief Agrega `n` bytes con valor `valor` a la corrida abierta, emitiendo las corridas que se
+     * cierran (cambio de valor o Conteo_Maximo del códec).
+     */
+    static void Agregar_Corrida(Corrida& corrida, uint8_t valor, uint64_t n, std::vector<uint8_t>& salida);
+
+    /**
+     * @brief Emite la corrida abierta (tupla o literales) y la reinicia.
+     */
+    static void Cerrar_Corrida(Corrida& corrida, std::vector<uint8_t>& salida);
+
+    /**
+     * @brief Versión sobre un buffer del llamador con al menos MAX_CIERRE_CORRIDA bytes.
+     * @return Bytes escritos.
+     */
+    static size_t Cerrar_Corrida(Corrida& corrida, uint8_t* salida);
+
+    /**
+     * @brief Actualiza los datos de frontera del tramo con la siguiente ventana de datos (incluido
+     * su CRC32C, que se compara con los checksums de los bloques al terminar).
+     */
+    static void Actualizar_Frontera(Frontera& frontera, const uint8_t* datos, size_t longitud);
+
     /**
      * @brief Realiza la descompresión RLE en un bloque de datos local.
      */
-    static std::vector<uint8_t> Descomprimir_Local(const std::vector<uint8_t>& compressed_buffer);
+    static std::vector<uint8_t> Descomprimir_Local(const std::vector<uint8_t>& compressed_buffer, uint8_t codec = RLEContainer::CODEC_RLE);
+
+    /**
+     * @brief Descomprime `longitud` bytes de `entrada` directamente en `salida`, sin reservar memoria.
+     * @return Bytes escritos, o SIN_CAPACIDAD si la salida excede `capacidad` (ver Longitud_Descomprimida).
+     */
+    static size_t Descomprimir_Local(const uint8_t* entrada, size_t longitud, uint8_t* salida, size_t capacidad, uint8_t codec = RLEContainer::CODEC_RLE);
+
+    /**
+     * @brief Recorre los tokens sin descomprimir y retorna el tamaño que produciría Descomprimir_Local.
+     */
+    static uint64_t Longitud_Descomprimida(const uint8_t* entrada, size_t longitud, uint8_t codec = RLEContainer::CODEC_RLE);
     
     /**
-     * @brief Corrige (recorta) los datos descomprimidos en las fronteras entre procesos.
-     * (Se usa para eliminar la redundancia del solapamiento.)
+     * @brief Corrige los datos comprimidos en las fronteras entre procesos para que la concatenación
+     * sea idéntica a Comprimir_Local sobre el archivo completo, con cualquier número de procesos.
+     * Un prefijo paralelo (MPI_Exscan) de resúmenes de tramo resuelve corridas de cualquier longitud
+     * que crucen varios procesos: el proceso donde empieza la corrida la emite completa al final de
+     * `local_output`. Los tokens iniciales que pertenecen a un proceso anterior no se borran: se
+     * retorna el offset en `local_output` donde empieza la salida válida de este proceso.
+     * Con Literales_En_Bloques no corrige nada: cada tramo es una codificación válida por sí sola.
      */
-    static void Corregir_Fronteras(std::vector<uint8_t>& local_output, const std::vector<uint8_t>& buffer_leido, size_t chunk_size, int rank, int size);
+    static size_t Corregir_Fronteras(std::vector<uint8_t>& local_output, const Frontera& frontera, int rank, int size, uint8_t codec = RLEContainer::CODEC_RLE);
     
     /**
-     * @brief Lee el bloque de datos asignado a un proceso usando MPI-I/O.
+     * @brief Divide una carga comprimida en bloques que terminan en fronteras de token.
+     * Cada bloque abarca al menos `tamano_objetivo` bytes descomprimidos (salvo el último) y lleva en
+     * `checksum` el CRC32C de esos bytes, calculado desde los tokens sin descomprimir: los literales
+     * se leen de la carga y las corridas se extienden con CRC32C_Combinar.
+     */
+    static std::vector<RLEContainer::Bloque> Dividir_En_Bloques(const uint8_t* carga, size_t longitud, size_t tamano_objetivo, uint8_t codec = RLEContainer::CODEC_RLE);
+
+    /**
+     * @brief Reemplaza por sus bytes originales (BLOQUE_ALMACENADO) los bloques de `carga` cuya
+     * codificación no es menor que ellos, de modo que ningún bloque crece. La carga se compacta en
+     * su lugar (un bloque almacenado nunca es más largo que su codificación).
+     * @return Nueva longitud de la carga.
+     */
+    static size_t Almacenar_Bloques(uint8_t* carga, std::vector<RLEContainer::Bloque>& bloques, uint8_t codec = RLEContainer::CODEC_RLE);
+
+    /**
+     * @brief Decodifica la carga de un bloque según su tipo en `salida` (longitud_original bytes).
+     * Con `verificar` también compara el CRC32C de la salida con el checksum del bloque.
+     * @return false si el bloque es de un tipo desconocido, su carga no produce longitud_original bytes
+     * o (con `verificar`) el CRC32C no coincide.
+     */
+    static bool Descomprimir_Bloque(const RLEContainer::Bloque& bloque, const uint8_t* carga, uint8_t* salida, uint8_t codec = RLEContainer::CODEC_RLE,
+                                    bool verificar = false);
+
+    /**
+     * @brief Concatena los tokens de los bloques de un contenedor en memoria. Los bloques almacenados
+     * se vuelven a codificar por sí solos, así que el resultado se compara con Comprimir_Local
+     * (con CODEC_RLE_ELEMENTOS se codifican con ancho 1: el ancho no se guarda en la cabecera).
+     */
+    static bool Extraer_Tokens(const std::vector<uint8_t>& archivo, std::vector<uint8_t>& tokens);
+
+    /**
+     * @brief Calcula el offset y la longitud del tramo de un proceso (división en partes casi iguales).
+     * Los cortes caen en múltiplos de `alineacion` (el ancho de elemento de CODEC_RLE_ELEMENTOS).
+     */
+    static void Calcular_Particion(uint64_t total, int rank, int size, uint64_t& offset, uint64_t& longitud, uint64_t alineacion = 1);
+
+    /**
+     * @brief Particiona [0, total) de `fh` equilibrando el costo estimado de cada proceso.
+     * Se comprime una muestra de cada región (repartidas entre los procesos) para estimar su costo
+     * (entrada + PESO_SALIDA * salida); los cortes se colocan en cuantiles del costo acumulado y se
+     * adelantan al siguiente cambio de valor, de modo que ninguna corrida cruce la frontera.
+     * Es colectiva en MPI_COMM_WORLD; todos los procesos obtienen los mismos cortes, que caen en
+     * múltiplos de `alineacion`.
+     */
+    static Particion Calcular_Particion_Balanceada(MPI_File fh, uint64_t total, int rank, int size, uint64_t alineacion = 1);
+
+    /**
+     * @brief Lee `longitud` bytes en `offset` con MPI_File_read_at, en trozos de a lo más `trozo` bytes.
+     */
+    static void Leer_MPIIO(MPI_File fh, MPI_Offset offset, uint8_t* datos, size_t longitud, size_t trozo = TROZO_MAX_IO);
+
+    /**
+     * @brief Escribe `longitud` bytes en `offset` con MPI_File_write_at_all, en trozos de a lo más `trozo` bytes.
+     * Es colectiva: todos los procesos de MPI_COMM_WORLD deben llamarla (con longitud 0 si no escriben).
+     */
+    static void Escribir_MPIIO_Colectivo(MPI_File fh, MPI_Offset offset, const uint8_t* datos, size_t longitud, size_t trozo = TROZO_MAX_IO);
+
+    /**
+     * @brief Recolecta en el rank 0 los bytes de todos los procesos en orden de rank.
+     * Usa MPI_Gatherv si el total cabe en `trozo`; si no, mensajes punto a punto de a lo más `trozo` bytes.
+     * @return Longitudes locales de cada proceso (solo en el rank 0).
+     */
+    static std::vector<uint64_t> Recolectar_En_Rank0(const uint8_t* local, uint64_t longitud, std::vector<uint8_t>& global, int rank, int size, size_t trozo = TROZO_MAX_IO);
+
+    /**
+     * @brief Lee el bloque de datos asignado a un proceso usando MPI-I/O. Con `alineacion` > 1 los
+     * tramos caen en fronteras de elemento y el elemento extra de frontera se lee completo.
      */
-    static void Leer_Bloque_MPIIO(const std::string& input_file, int rank, int size, std::vector<uint8_t>& buffer_in, size_t& global_file_size,size_t& offset_start);
+    static void Leer_Bloque_MPIIO(const std::string& input_file, int rank, int size, std::vector<uint8_t>& buffer_in, size_t& global_file_size,size_t& offset_start,
+                                  size_t alineacion = 1);
 };
 
 // Funciones de prueba/utilidad
@@ -0,0 +1,161 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+#ifndef RLE_CONTAINER_HPP
+#define RLE_CONTAINER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+/**
+ * @brief Formato contenedor por bloques del archivo comprimido (versionado).
+ *
+ * Disposición en disco (enteros little-endian):
+ *
+ *   [Cabecera] [Registro | Carga]* [Registro FIN] [Índice] [Pie]
+ *
+ * - Cabecera (32 B): "RLEX", versión, códec, banderas, tamaño original.
+ * - Registro (24 B): tipo, checksum, longitud comprimida y original del bloque.
+ * - Índice (24 B por bloque): offset del registro, longitud comprimida y original.
+ * - Pie (24 B): offset del índice, número de bloques y "RLXI".
+ *
+ * Cada bloque contiene únicamente tokens RLE completos, por lo que puede
+ * descomprimirse de forma independiente a partir de su entrada en el índice.
+ */
+class RLEContainer {
+public:
+    static constexpr uint8_t VERSION = 1;
+
+    static constexpr size_t TAMANO_CABECERA = 32;
+    static constexpr size_t TAMANO_REGISTRO = 24;
+    static constexpr size_t TAMANO_ENTRADA_INDICE = 24;
+    static constexpr size_t TAMANO_PIE = 24;
+
+    // Códecs de la carga (campo códec de la cabecera)
+    static constexpr uint8_t CODEC_RLE = 0;         // Tuplas [0xFF][conteo][valor] con conteo de 1 byte (hasta 255)
+    static constexpr uint8_t CODEC_RLE_VARINT = 1;  // Conteo LEB128: cada corrida, de cualquier longitud, es una tupla
+    static constexpr uint8_t CODEC_RLE_LITERALES = 2;  // Tuplas LEB128 y bloques [0xFE][longitud LEB128][bytes] sin escapes
+    static constexpr uint8_t CODEC_RLE_ELEMENTOS = 3;  // CODEC_RLE_LITERALES más corridas de elementos de varios bytes y planos de bytes
+    static constexpr uint8_t CODEC_MAXIMO = CODEC_RLE_ELEMENTOS;
+
+    // Banderas de la cabecera
+    static constexpr uint16_t BANDERA_CRC32C = 1;  // El checksum de cada registro es el CRC32C de los bytes originales del bloque
+    static constexpr uint16_t BANDERA_TAMANO_EN_INDICE = 2;  // Entrada por flujo: tamano_original es 0 y el tamaño es la suma de los bloques
+
+    // Tipos de registro de bloque
+    static constexpr uint8_t BLOQUE_RLE = 0;     // Carga con tokens RLE
+    static constexpr uint8_t BLOQUE_ALMACENADO = 1;  // Carga con los bytes originales (la codificación no los reducía)
+    static constexpr uint8_t BLOQUE_FIN = 0xFF;  // Marca el final de los bloques
+
+    /**
+     * @brief Metadatos globales del archivo comprimido.
+     */
+    struct Cabecera {
+        uint8_t version = VERSION;
+        uint8_t codec = 0;
+        uint16_t banderas = 0;
+        uint64_t tamano_original = 0;
+    };
+
+    /**
+     * @brief Descriptor de un bloque (registro en disco + entrada del índice).
+     */
+    struct Bloque {
+        uint64_t offset = 0;               // Offset absoluto del registro del bloque
+        uint64_t longitud_comprimida = 0;  // Bytes de carga (sin el registro)
+        uint64_t longitud_original = 0;    // Bytes que produce al descomprimirse
+        uint8_t tipo = BLOQUE_RLE;
+        uint32_t checksum = 0;
+    };
+
+    /**
+     * @brief Escribe la cabecera en `destino` (TAMANO_CABECERA bytes).
+     */
+    static void Serializar_Cabecera(const Cabecera& cabecera, uint8_t* destino);
+
+    /**
+     * @brief Lee la cabecera. Retorna false si no tiene la firma o la versión o el códec no son soportados.
+     */
+    static bool Parsear_Cabecera(const uint8_t* origen, Cabecera& cabecera);
+
+    /**
+     * @brief Escribe el registro que precede a la carga de un bloque (TAMANO_REGISTRO bytes).
+     */
+    static void Serializar_Registro(const Bloque& bloque, uint8_t* destino);
+
+    /**
+     * @brief Lee un registro de bloque. El offset se deja en 0 (no se almacena en el registro).
+     */
+    static Bloque Parsear_Registro(const uint8_t* origen);
+
+    /**
+     * @brief Calcula el offset de cada bloque colocándolos consecutivamente desde `inicio`.
+     * @return Offset inmediatamente posterior a la carga del último bloque.
+     */
+    static uint64_t Asignar_Offsets(std::vector<Bloque>& bloques, uint64_t inicio);
+
+    /**
+     * @brief Serializa las entradas del índice de `bloques` (TAMANO_ENTRADA_INDICE bytes cada una).
+     */
+    static std::vector<uint8_t> Serializar_Entradas(const std::vector<Bloque>& bloques);
+
+    /**
+     * @brief Escribe el pie en `destino` (TAMANO_PIE bytes).
+     */
+    static void Serializar_Pie(uint64_t offset_indice, uint64_t num_bloques, uint8_t* destino);
+
+    /**
+     * @brief Serializa la cola del archivo: registro FIN, índice y pie.
+     * @param offset_cola Offset absoluto donde se escribirá la cola.
+     */
+    static std::vector<uint8_t> Serializar_Cola(const std::vector<Bloque>& bloques, uint64_t offset_cola);
+
+    /**
+     * @brief Lee el pie y valida la firma y su coherencia con el tamaño del archivo.
+     */
+    static bool Parsear_Pie(const uint8_t* pie, uint64_t tamano_archivo, uint64_t& offset_indice, uint64_t& num_bloques);
+
+    /**
+     * @brief Lee las entradas del índice y valida que los bloques vayan seguidos, en orden, desde la
+     * cabecera hasta el registro FIN.
+     */
+    static bool Parsear_Indice(const uint8_t* indice, uint64_t num_bloques, uint64_t offset_indice, std::vector<Bloque>& bloques);
+
+    /**
+     * @brief Analiza un archivo contenedor completo en memoria.
+     * @return false si los datos no son un contenedor válido (p. ej. un .rle heredado sin cabecera).
+     */
+    static bool Parsear(const uint8_t* datos, size_t longitud, Cabecera& cabecera, std::vector<Bloque>& bloques);
+
+    /**
+     * @brief Escribe la cabecera en un flujo (primer paso de una escritura incremental).
+     */
+    static bool Escribir_Cabecera(std::ostream& os, const Cabecera& cabecera);
+
+    /**
+     * @brief Escribe el registro y la carga de un bloque a continuación del anterior.
+     */
+    static bool Escribir_Bloque(std::ostream& os, const Bloque& bloque, const uint8_t* carga);
+
+    /**
+     * @brief Escribe la cola (registro FIN, índice y pie) tras los bloques ya escritos con Escribir_Bloque.
+     */
+    static bool Escribir_Cola(std::ostream& os, std::vector<Bloque> bloques);
+
+    /**
+     * @brief Escribe un contenedor completo. `carga` contiene las cargas de los bloques concatenadas.
+     */
+    static bool Escribir(std::ostream& os, const Cabecera& cabecera, const uint8_t* carga, std::vector<Bloque> bloques);
+
+    /**
+     * @brief Concatena las cargas de todos los bloques de un contenedor en memoria.
+     */
+    static bool Extraer_Carga(const std::vector<uint8_t>& archivo, std::vector<uint8_t>& carga);
+};
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+#ifndef RLE_KERNELS_HPP
+#define RLE_KERNELS_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Implementaciones disponibles de los núcleos de búsqueda de corridas.
+ */
+enum class ImplementacionSIMD {
+    Escalar,  // Byte a byte (cualquier plataforma)
+    SSE2,     // 16 bytes por comparación (x86-64)
+    AVX2      // 32 bytes por comparación (x86-64 con AVX2)
+};
+
+/**
+ * @brief Núcleos vectorizados que usan el codificador y el decodificador RLE para recorrer la entrada.
+ *
+ * La implementación se elige al iniciar el programa según la CPU (AVX2, SSE2 o escalar)
+ * y todas producen exactamente el mismo resultado.
+ */
+class RLEKernels {
+public:
+    /**
+     * @brief Número de bytes iniciales de `datos` iguales a `valor` (a lo más `longitud`).
+     */
+    static size_t Longitud_Corrida(const uint8_t* datos, size_t longitud, uint8_t valor);
+
+    /**
+     * @brief Longitud del prefijo de `datos` que el codificador emite como literales sin escapar:
+     * no contiene bytes bandera (0xFE/0xFF) ni bytes que inicien una corrida de 3 o más.
+     * Los dos últimos bytes nunca se incluyen (su corrida podría continuar en la siguiente ventana).
+     */
+    static size_t Longitud_Literales(const uint8_t* datos, size_t longitud);
+
+    /**
+     * @brief Número de bytes iniciales de `datos` que no son bandera (0xFE/0xFF). El decodificador
+     * copia ese tramo de literales en bloque.
+     */
+    static size_t Longitud_Sin_Banderas(const uint8_t* datos, size_t longitud);
+
+    /**
+     * @brief CRC32C (Castagnoli) de `datos` a continuación de `crc`, el CRC de los bytes anteriores
+     * (0 al empezar). Usa la instrucción crc32 de SSE4.2 si la CPU la tiene, salvo con la
+     * implementación escalar.
+     */
+    static uint32_t CRC32C(const uint8_t* datos, size_t longitud, uint32_t crc = 0);
+
+    /**
+     * @brief CRC32C de la concatenación A + B a partir de crc1 = CRC32C(A), crc2 = CRC32C(B) y la
+     * longitud de B, sin leer los datos (O(log longitud2)).
+     */
+    static uint32_t CRC32C_Combinar(uint32_t crc1, uint32_t crc2, uint64_t longitud2);
+
+    /**
+     * @brief Indica si CRC32C usa la instrucción de hardware.
+     */
+    static bool CRC32C_Por_Hardware();
+
+    /**
+     * @brief Implementación en uso.
+     */
+    static ImplementacionSIMD Implementacion_Activa();
+
+    /**
+     * @brief Cambia la implementación en uso (pruebas y benchmarks).
+     * @return false si la CPU no la soporta (se conserva la actual).
+     */
+    static bool Seleccionar_Implementacion(ImplementacionSIMD implementacion);
+
+    /**
+     * @brief Mejor implementación soportada por la CPU.
+     */
+    static ImplementacionSIMD Detectar_Implementacion();
+
+    static const char* Nombre(ImplementacionSIMD implementacion);
+};
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+#ifndef SALIDA_DIRECTA_HPP
+#define SALIDA_DIRECTA_HPP
+
+#include <streambuf>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Buffer de salida (std::streambuf) que escribe un archivo con O_DIRECT.
+ *
+ * Los datos se acumulan en un buffer alineado y se escriben en trozos alineados sin pasar por la
+ * caché de páginas. Al cerrar, la cola se rellena hasta la alineación y el archivo se trunca a su
+ * longitud real. Si el sistema de archivos no admite O_DIRECT se usan escrituras normales.
+ * Se usa con `std::ostream os(&salida)`, por lo que las funciones de RLEContainer no cambian.
+ */
+class SalidaDirecta : public std::streambuf {
+public:
+    static constexpr size_t ALINEACION = 4096;
+    static constexpr size_t TAMANO_BUFFER = (size_t)4 << 20;
+
+    SalidaDirecta() = default;
+    ~SalidaDirecta();
+
+    SalidaDirecta(const SalidaDirecta&) = delete;
+    SalidaDirecta& operator=(const SalidaDirecta&) = delete;
+
+    /**
+     * @return false si no se pudo crear el archivo o reservar el buffer.
+     */
+    bool Abrir(const std::string& ruta);
+
+    /**
+     * @brief Escribe la cola, ajusta la longitud del archivo y lo cierra.
+     * @return false si alguna escritura falló.
+     */
+    bool Cerrar();
+
+    /**
+     * @brief Indica si las escrituras evitan la caché de páginas (O_DIRECT aceptado).
+     */
+    bool Directa() const { return directa; }
+
+protected:
+    int_type overflow(int_type c) override;
+
+private:
+    bool Escribir(const uint8_t* datos, size_t longitud);
+
+    int fd = -1;
+    bool directa = false;
+    bool error = false;
+    uint8_t* buffer = nullptr;
+    uint64_t escritos = 0;
+};
+
+#endif
@@ -1,10 +1,32 @@
 #!/bin/bash
 
-EXECUTABLE="./build/rle_compressor"
+EXECUTABLE=${EXECUTABLE:-./build/rle_compressor}
 DATA_DIR="test_data"
-INPUT_FILES=("data_plana.bin" "data_aleatoria.bin" "data_malla.bin")
-N_PROCESSES=(2 4 6 8 10 16)  
-REPETITIONS=5               
+INPUT_FILES=(${INPUT_FILES:-data_plana.bin data_aleatoria.bin data_malla.bin})
+N_PROCESSES=(${N_PROCESSES:-2 4 6 8 10 16})
+REPETITIONS=${REPETITIONS:-5}
+# Escritura de la salida paralela: "collective" (MPI-IO) y/o "gather" (MPI_Gatherv a rank 0)
+WRITE_MODES=(${WRITE_MODES:-collective gather})
+# Hilos por proceso (--threads): se combinan con cada número de procesos (ranks x hilos)
+THREADS=(${THREADS:-1 2 4})
+# Mide también la descompresión de cada archivo comprimido (DECOMPRESS=0 para omitirla)
+DECOMPRESS=${DECOMPRESS:-1}
+# Formas sintéticas de build/data_generator (--preset) que se generan en test_data/sint_<forma>.bin
+# y se suman a INPUT_FILES, p. ej. SYNTHETIC="zipf mixta fronteras". Todas colocan además corridas
+# sobre las fronteras de los P de N_PROCESSES. SYNTHETIC_SIZE acepta sufijos K/M/G/T.
+SYNTHETIC=(${SYNTHETIC:-})
+SYNTHETIC_SIZE=${SYNTHETIC_SIZE:-100M}
+SEED=${SEED:-1}
+GENERATOR=${GENERATOR:-./build/data_generator}
+# Estudio de escalabilidad en lugar del barrido anterior: SCALING=strong (tamaño fijo, P creciente),
+# weak (WEAK_SIZE_MB por proceso, generado con WEAK_PRESET) o both. P=1 se agrega como referencia.
+SCALING=${SCALING:-}
+WEAK_SIZE_MB=${WEAK_SIZE_MB:-64}
+WEAK_PRESET=${WEAK_PRESET:-geometrica}
+SCALING_THREADS=${SCALING_THREADS:-1}
+# Afinidad de los ranks en el estudio (mpirun --map-by/--bind-to); sin núcleos suficientes se usa none
+MAP=${MAP:-core}
+BIND=${BIND:-core}
 OUTPUT_CSV="benchmark_results_$(date +%Y%m%d_%H%M%S).csv"
 
 GREEN='\033[0;32m'
@@ -22,6 +44,189 @@ if [ ! -d "$DATA_DIR" ]; then
     exit 1
 fi
 
+if [ ${#SYNTHETIC[@]} -gt 0 ]; then
+    if [ ! -f "$GENERATOR" ]; then
+        echo -e "${RED}ERROR:${NC} Generador '$GENERATOR' no encontrado (ejecute 'make build/data_generator')."
+        exit 1
+    fi
+    # Se regeneran siempre: el archivo depende de SYNTHETIC_SIZE, SEED y N_PROCESSES
+    STRADDLE=$(for p in "${N_PROCESSES[@]}"; do [ "$p" -gt 1 ] && echo "$p"; done | paste -sd, -)
+    for preset in "${SYNTHETIC[@]}"; do
+        echo -e "${BLUE}Generando sint_${preset}.bin ($SYNTHETIC_SIZE, semilla $SEED, fronteras de P=$STRADDLE)...${NC}"
+        if ! "$GENERATOR" --preset "$preset" --size "$SYNTHETIC_SIZE" --seed "$SEED" ${STRADDLE:+--straddle "$STRADDLE"} \
+                --output "$DATA_DIR/sint_${preset}.bin"; then
+            echo -e "${RED}ERROR:${NC} No se pudo generar la forma sintética '$preset'."
+            exit 1
+        fi
+        INPUT_FILES+=("sint_${preset}.bin")
+    done
+fi
+
+# --- Estudio de escalabilidad (SCALING) ---
+# Los tiempos salen de --metrics (fase total: el rank más lento, sin el arranque de mpirun ni
+# MPI_Init) en lugar de la salida estándar. Cada compresión se descomprime con los mismos P.
+
+# Banderas de afinidad para n_procs ranks de SCALING_THREADS hilos; sin núcleos suficientes
+# mpirun no puede fijarlos y se usa --bind-to none (queda registrado en la columna afinidad).
+afinidad_mpirun() {
+    local n_procs=$1
+    if [ $((n_procs * SCALING_THREADS)) -gt "$(nproc)" ]; then
+        echo "--oversubscribe --bind-to none"
+    elif [ "$SCALING_THREADS" -gt 1 ]; then
+        echo "--map-by ${MAP}:PE=${SCALING_THREADS} --bind-to $BIND"
+    else
+        echo "--map-by $MAP --bind-to $BIND"
+    fi
+}
+
+# Ejecuta una operación con --metrics y agrega su fila a SCALING_CSV
+run_scaling_op() {
+    local study=$1
+    local operation=$2
+    local label=$3
+    local n_procs=$4
+    local rep=$5
+    shift 5
+    local flags=$(afinidad_mpirun $n_procs)
+    local metrics_file="temp_metrics_${study}_${operation}_${n_procs}_${rep}.csv"
+    local log_file="temp_log_${study}_${operation}_${n_procs}_${rep}.txt"
+
+    mpirun -np $n_procs $flags "$@" --threads $SCALING_THREADS --metrics "$metrics_file" > "$log_file" 2>&1
+
+    # Columnas de --metrics: fase=5, tiempo_max_s=7, bytes=10, gb_s=11, rss_pico_max_B=12
+    local row=$(awk -F ',' '
+        $5 == "lectura" { lectura = $7 } $5 == "codificacion" { codificacion = $7 }
+        $5 == "fronteras" { fronteras = $7 } $5 == "escritura" { escritura = $7 }
+        $5 == "total" { printf "%s,%s,%s,%s,%s,%s,%s,%s", $10, $7, lectura, codificacion, fronteras, escritura, $11, $12 }
+    ' "$metrics_file" 2>/dev/null)
+
+    if [ -n "$row" ]; then
+        local binding=$(echo "$flags" | sed 's/.*--bind-to //')
+        echo "$study,$operation,$label,$n_procs,$SCALING_THREADS,$binding,$rep,$row" >> "$SCALING_CSV"
+        echo -e "    ${GREEN}OK ($operation):${NC} T=$(echo "$row" | cut -d, -f2) s"
+        rm -f "$log_file"
+    else
+        echo -e "    ${RED}FALLO ($operation):${NC} Revisar: $log_file"
+    fi
+    rm -f "$metrics_file"
+}
+
+# Comprime y descomprime file_path con n_procs procesos REPETITIONS veces
+run_scaling_point() {
+    local study=$1
+    local file_path=$2
+    local label=$3
+    local n_procs=$4
+    local compressed="${file_path}.rle"
+
+    echo -e "${BLUE}--- ${study}: ${label}, P=${n_procs} ($(afinidad_mpirun $n_procs)) ---${NC}"
+    for (( i=1; i<=$REPETITIONS; i++ )); do
+        run_scaling_op "$study" compresion "$label" $n_procs $i \
+            $EXECUTABLE "$file_path" --parallel --output "$compressed"
+        run_scaling_op "$study" descompresion "$label" $n_procs $i \
+            $EXECUTABLE "$compressed" --parallel --decompress --output "${compressed}.out"
+        rm -f "$compressed" "${compressed}.out"
+    done
+}
+
+# Promedia las repeticiones y calcula, respecto a P=1 del mismo estudio, operación y archivo:
+#   strong: speedup S = T1/Tp y eficiencia E = S/P
+#   weak:   eficiencia E = T1/Tp y speedup escalado S = P*T1/Tp
+#   Karp-Flatt (P > 1): e = (1/S - 1/P) / (1 - 1/P), la fracción serial observada
+summarize_scaling() {
+    awk -F ',' -v json="$SCALING_JSON" '
+        NR == 1 { next }
+        {
+            key = $1 "," $2 "," $3 "," $4
+            if (!(key in count)) order[n++] = key
+            sum_time[key] += $9
+            sum_gbs[key] += $14
+            bytes[key] = $8
+            if ($15 > rss[key]) rss[key] = $15
+            binding[key] = $6
+            threads[key] = $5
+            count[key]++
+        }
+        END {
+            printf "\n%-7s | %-13s | %-24s | %-4s | %-10s | %-8s | %-10s | %-11s | %-8s | %-10s\n", "Estudio", "Operacion", "Archivo", "P", "Tiempo (s)", "Speedup", "Eficiencia", "Karp-Flatt", "GB/s", "RSS (MiB)"
+            printf "%s\n", "--------|---------------|--------------------------|------|------------|----------|------------|-------------|----------|-----------"
+            printf "[\n" > json
+            for (i = 0; i < n; i++) {
+                key = order[i]
+                split(key, k, ",")
+                t = sum_time[key] / count[key]
+                base = k[1] "," k[2] "," k[3] ",1"
+                speedup = ""; efficiency = ""; kf = ""
+                if ((base in count) && t > 0) {
+                    t1 = sum_time[base] / count[base]
+                    p = k[4]
+                    speedup = (k[1] == "weak") ? p * t1 / t : t1 / t
+                    efficiency = speedup / p
+                    if (p > 1) kf = (1 / speedup - 1 / p) / (1 - 1 / p)
+                }
+                gbs = sum_gbs[key] / count[key]
+                printf "%-7s | %-13s | %-24s | %-4s | %-10.4f | %-8s | %-10s | %-11s | %-8.3f | %-10.1f\n", k[1], k[2], k[3], k[4], t, \
+                    (speedup == "" ? "N/A" : sprintf("%.2f", speedup)), (efficiency == "" ? "N/A" : sprintf("%.3f", efficiency)), \
+                    (kf == "" ? "N/A" : sprintf("%.4f", kf)), gbs, rss[key] / 1048576
+                printf "  {\"estudio\": \"%s\", \"operacion\": \"%s\", \"archivo\": \"%s\", \"procesos\": %d, \"hilos\": %d, \"afinidad\": \"%s\", \"repeticiones\": %d, \"tamano_B\": %s, \"tiempo_s\": %.6f, \"speedup\": %s, \"eficiencia\": %s, \"karp_flatt\": %s, \"gb_s\": %.6f, \"rss_pico_max_B\": %s}%s\n", \
+                    k[1], k[2], k[3], k[4], threads[key], binding[key], count[key], bytes[key], t, \
+                    (speedup == "" ? "null" : sprintf("%.6f", speedup)), (efficiency == "" ? "null" : sprintf("%.6f", efficiency)), \
+                    (kf == "" ? "null" : sprintf("%.6f", kf)), gbs, rss[key], (i + 1 < n ? "," : "") > json
+            }
+            printf "]\n" > json
+        }' "$SCALING_CSV"
+}
+
+run_scaling() {
+    SCALING_CSV="scaling_results_$(date +%Y%m%d_%H%M%S).csv"
+    SCALING_JSON="${SCALING_CSV%.csv}.json"
+    local procs_list=(1)
+    for p in "${N_PROCESSES[@]}"; do
+        [ "$p" -gt 1 ] && procs_list+=("$p")
+    done
+
+    echo "estudio,operacion,archivo,procesos,hilos,afinidad,repeticion,tamano_B,tiempo_s,lectura_s,codificacion_s,fronteras_s,escritura_s,gb_s,rss_pico_max_B" > "$SCALING_CSV"
+    echo -e "${GREEN}Estudio de escalabilidad ($SCALING), P = ${procs_list[*]}: ${SCALING_CSV}${NC}"
+
+    if [ "$SCALING" == "strong" ] || [ "$SCALING" == "both" ]; then
+        for file in "${INPUT_FILES[@]}"; do
+            for procs in "${procs_list[@]}"; do
+                run_scaling_point strong "$DATA_DIR/$file" "$file" $procs
+            done
+        done
+    fi
+
+    if [ "$SCALING" == "weak" ] || [ "$SCALING" == "both" ]; then
+        if [ ! -f "$GENERATOR" ]; then
+            echo -e "${RED}ERROR:${NC} Generador '$GENERATOR' no encontrado (ejecute 'make build/data_generator')."
+            exit 1
+        fi
+        local label="${WEAK_PRESET}_${WEAK_SIZE_MB}MiB_por_P"
+        for procs in "${procs_list[@]}"; do
+            local weak_file="$DATA_DIR/weak_${WEAK_PRESET}_p${procs}.bin"
+            local straddle=""
+            [ "$procs" -gt 1 ] && straddle="--straddle $procs"
+            "$GENERATOR" --preset "$WEAK_PRESET" --size "$((procs * WEAK_SIZE_MB))M" --seed "$SEED" $straddle \
+                --output "$weak_file" > /dev/null || exit 1
+            run_scaling_point weak "$weak_file" "$label" $procs
+            rm -f "$weak_file"
+        done
+    fi
+
+    summarize_scaling
+    echo ""
+    echo -e "${GREEN}Resultados: ${SCALING_CSV} (por repetición) y ${SCALING_JSON} (resumen)${NC}"
+}
+
+if [ -n "$SCALING" ]; then
+    if [ "$SCALING" != "strong" ] && [ "$SCALING" != "weak" ] && [ "$SCALING" != "both" ]; then
+        echo -e "${RED}ERROR:${NC} SCALING debe ser strong, weak o both."
+        exit 1
+    fi
+    run_scaling
+    exit 0
+fi
+
 echo "archivo,modo,procesos,repeticion,tiempo_s,tamano_original_B,tamano_comprimido_B" > "$OUTPUT_CSV"
 echo -e "${GREEN}Resultados se guardarán en: ${OUTPUT_CSV}${NC}"
 
@@ -30,10 +235,12 @@ run_test() {
     local mode=$2
     local n_procs=$3
     local rep=$4
+    local write_mode=${5:-collective}
+    local n_threads=${6:-1}
 
     local command
     local output_file="${file_path}.rle"
-    local log_file="temp_log_$(basename $file_path)_${n_procs}_${rep}.txt"
+    local log_file="temp_log_$(basename $file_path)_${n_procs}_${write_mode}_t${n_threads}_${rep}.txt"
     local mpirun_flags=""
 
     if [ "$mode" == "--secuencial" ]; then
@@ -41,8 +248,11 @@ run_test() {
         command="$EXECUTABLE $file_path --secuencial --output $output_file"
         mpirun -np 1 $command > "$log_file" 2>&1
     else
-        echo -e "${BLUE}  -> Ejecutando Paralelo con $n_procs P (Rep $rep)...${NC}"
-        command="$EXECUTABLE $file_path --parallel --output $output_file"
+        echo -e "${BLUE}  -> Ejecutando Paralelo con $n_procs P x $n_threads H, escritura $write_mode (Rep $rep)...${NC}"
+        command="$EXECUTABLE $file_path --parallel --threads $n_threads --output $output_file"
+        if [ "$write_mode" == "gather" ]; then
+            command="$command --gather"
+        fi
         
         mpirun_flags="--oversubscribe --bind-to none"
         
@@ -54,17 +264,64 @@ run_test() {
     local size_comp=$(grep "Tamaño Comprimido:" "$log_file" | awk '{print $3}')
     local file_name=$(basename "$file_path")
     local proc_str="1" 
+    local mode_str=$(echo $mode | sed 's/--//')
     if [ "$mode" == "--parallel" ]; then
         proc_str="$n_procs"
+        mode_str="${mode_str}_${write_mode}_t${n_threads}"
     fi
 
     if [ ! -z "$time" ]; then
-        echo "$file_name,$(echo $mode | sed 's/--//'),$proc_str,$rep,$time,$size_orig,$size_comp" >> "$OUTPUT_CSV"
+        echo "$file_name,$mode_str,$proc_str,$rep,$time,$size_orig,$size_comp" >> "$OUTPUT_CSV"
         echo -e "    ${GREEN}OK:${NC} T=$time s"
         rm -f "$log_file"
+        if [ "$DECOMPRESS" == "1" ]; then
+            run_decompress_test "$output_file" "$file_name" "$mode" "$n_procs" "$rep" "$write_mode" "$mode_str" "$proc_str" "$n_threads"
+        fi
     else
         echo -e "    ${RED}FALLO:${NC} No se pudo extraer el tiempo de ejecución. Revisar: $log_file"
-        echo "$file_name,$(echo $mode | sed 's/--//'),$proc_str,$rep,FALLO,FALLO,FALLO" >> "$OUTPUT_CSV"
+        echo "$file_name,$mode_str,$proc_str,$rep,FALLO,FALLO,FALLO" >> "$OUTPUT_CSV"
+    fi
+
+    rm -f "$output_file"
+}
+
+# Descomprime la salida de run_test con el mismo modo y número de procesos.
+# Se registra como modo "descompresion_<modo>"; tamano_original_B es el tamaño descomprimido.
+run_decompress_test() {
+    local compressed_file=$1
+    local file_name=$2
+    local mode=$3
+    local n_procs=$4
+    local rep=$5
+    local write_mode=$6
+    local mode_str="descompresion_$7"
+    local proc_str=$8
+    local n_threads=${9:-1}
+
+    local output_file="${compressed_file}.out"
+    local log_file="temp_log_${file_name}_${n_procs}_${write_mode}_t${n_threads}_${rep}_d.txt"
+    local command="$EXECUTABLE $compressed_file $mode --decompress --threads $n_threads --output $output_file"
+
+    if [ "$mode" == "--secuencial" ]; then
+        mpirun -np 1 $command > "$log_file" 2>&1
+    else
+        if [ "$write_mode" == "gather" ]; then
+            command="$command --gather"
+        fi
+        mpirun -np $n_procs --oversubscribe --bind-to none $command > "$log_file" 2>&1
+    fi
+
+    local time=$(grep "Tiempo:" "$log_file" | awk '{print $2}')
+    local size_dec=$(grep "Tamaño Descomprimido:" "$log_file" | awk '{print $3}')
+    local size_comp=$(grep "Tamaño Comprimido:" "$log_file" | awk '{print $3}')
+
+    if [ ! -z "$time" ]; then
+        echo "$file_name,$mode_str,$proc_str,$rep,$time,$size_dec,$size_comp" >> "$OUTPUT_CSV"
+        echo -e "    ${GREEN}OK (descompresión):${NC} T=$time s"
+        rm -f "$log_file"
+    else
+        echo -e "    ${RED}FALLO (descompresión):${NC} Revisar: $log_file"
+        echo "$file_name,$mode_str,$proc_str,$rep,FALLO,FALLO,FALLO" >> "$OUTPUT_CSV"
     fi
 
     rm -f "$output_file"
@@ -86,8 +343,12 @@ for file in "${INPUT_FILES[@]}"; do
     for procs in "${N_PROCESSES[@]}"; do
         echo ""
         echo -e "${BLUE}--- PRUEBAS PARALELAS (P=${procs}) ---${NC}"
-        for (( i=1; i<=$REPETITIONS; i++ )); do
-            run_test "$FILE_PATH" "--parallel" $procs $i
+        for threads in "${THREADS[@]}"; do
+            for write_mode in "${WRITE_MODES[@]}"; do
+                for (( i=1; i<=$REPETITIONS; i++ )); do
+                    run_test "$FILE_PATH" "--parallel" $procs $i $write_mode $threads
+                done
+            done
         done
     done
 done
@@ -104,15 +365,16 @@ awk -F ',' '
     BEGIN {
         OFS="|";
         printf "\n"
-        printf "%-20s | %-8s | %-18s | %-12s\n", "Archivo", "Procesos", "Tiempo Promedio (s)", "Speedup"
-        printf "%s\n", "---------------------|----------|--------------------|--------------"
+        printf "%-20s | %-36s | %-8s | %-18s | %-12s | %-12s\n", "Archivo", "Modo", "Procesos", "Tiempo Promedio (s)", "Speedup", "MB/s"
+        printf "%s\n", "---------------------|--------------------------------------|----------|--------------------|--------------|--------------"
     }
 
     # Procesar datos
     NR == 1 || $5 == "FALLO" { next } # Saltar encabezado y fallos
     {
-        key = $1 "," $3
+        key = $1 "," $3 "," $2
         sum_time[key] += $5
+        sum_bytes[key] += $6
         count[key]++
     }
     
@@ -121,10 +383,11 @@ awk -F ',' '
         for (key in sum_time) {
             split(key, arr, ",")
             file = arr[1]
-            procs = arr[2]
+            mode = arr[3]
             
-            if (procs == 1) {
-                sequential_time[file] = sum_time[key] / count[key]
+            # La descompresión se compara con la descompresión secuencial
+            if (mode == "secuencial" || mode == "descompresion_secuencial") {
+                sequential_time[file "," mode] = sum_time[key] / count[key]
             }
         }
         
@@ -135,15 +398,18 @@ awk -F ',' '
             split(key, arr, ",")
             file = arr[1]
             procs = arr[2]
+            mode = arr[3]
 
             avg_time = sum_time[key] / count[key]
+            baseline = (mode ~ /^descompresion_/) ? "descompresion_secuencial" : "secuencial"
             
             speedup = "N/A"
-            if (sequential_time[file] > 0) {
-                speedup = sequential_time[file] / avg_time
+            if (sequential_time[file "," baseline] > 0) {
+                speedup = sequential_time[file "," baseline] / avg_time
             }
+            throughput = (sum_time[key] > 0) ? (sum_bytes[key] / 1e6) / sum_time[key] : 0
             
-            printf "%-20s | %-8s | %-18.4f | %-12.2f\n", file, procs, avg_time, (speedup == "N/A" ? 0 : speedup)
+            printf "%-20s | %-36s | %-8s | %-18.4f | %-12.2f | %-12.1f\n", file, mode, procs, avg_time, (speedup == "N/A" ? 0 : speedup), throughput
         }
     }' "$OUTPUT_CSV" 
 
@@ -0,0 +1,55 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+
+#include "../include/ArchivoMapeado.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+ArchivoMapeado::~ArchivoMapeado() {
+    Cerrar();
+}
+
+bool ArchivoMapeado::Abrir(const string& ruta) {
+    Cerrar();
+
+    int fd = open(ruta.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return true;
+    }
+
+    // La proyección sigue siendo válida después de cerrar el descriptor
+    void* proyeccion = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (proyeccion == MAP_FAILED) return false;
+
+    datos = (uint8_t*)proyeccion;
+    longitud = (size_t)info.st_size;
+
+    // Solo son sugerencias: se ignoran los errores (p. ej. sistemas sin páginas grandes para archivos)
+    madvise(datos, longitud, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(datos, longitud, MADV_HUGEPAGE);
+#endif
+    return true;
+}
+
+void ArchivoMapeado::Cerrar() {
+    if (datos != nullptr) munmap(datos, longitud);
+    datos = nullptr;
+    longitud = 0;
+}
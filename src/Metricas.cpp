@@ -0,0 +1,107 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+
+#include "../include/Metricas.hpp"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <sys/resource.h>
+
+using namespace std;
+
+void Metricas::Registrar(Fase fase, double segundos, uint64_t n) {
+    tiempos[(int)fase] += segundos;
+    bytes[(int)fase] += n;
+}
+
+const char* Metricas::Nombre(Fase fase) {
+    switch (fase) {
+        case Fase::Lectura: return "lectura";
+        case Fase::Codificacion: return "codificacion";
+        case Fase::Fronteras: return "fronteras";
+        case Fase::Escritura: return "escritura";
+        default: return "total";
+    }
+}
+
+uint64_t Metricas::Memoria_Pico() {
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) != 0) return 0;
+    return (uint64_t)uso.ru_maxrss * 1024;
+}
+
+static bool Termina_En(const string& texto, const string& sufijo) {
+    return texto.size() >= sufijo.size() && texto.compare(texto.size() - sufijo.size(), sufijo.size(), sufijo) == 0;
+}
+
+bool Metricas::Reducir_Y_Escribir(const string& archivo, const string& operacion, const string& modo, int hilos, MPI_Comm comm) const {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    double minimo[NUM_FASES], maximo[NUM_FASES], suma[NUM_FASES];
+    uint64_t bytes_totales[NUM_FASES];
+    MPI_Reduce(tiempos, minimo, NUM_FASES, MPI_DOUBLE, MPI_MIN, 0, comm);
+    MPI_Reduce(tiempos, maximo, NUM_FASES, MPI_DOUBLE, MPI_MAX, 0, comm);
+    MPI_Reduce(tiempos, suma, NUM_FASES, MPI_DOUBLE, MPI_SUM, 0, comm);
+    MPI_Reduce(bytes, bytes_totales, NUM_FASES, MPI_UINT64_T, MPI_SUM, 0, comm);
+
+    // Memoria residente pico de cada proceso hasta este punto (ru_maxrss está en KiB en Linux)
+    uint64_t rss = Memoria_Pico();
+    vector<uint64_t> rss_procesos(rank == 0 ? size : 0);
+    MPI_Gather(&rss, 1, MPI_UINT64_T, rss_procesos.data(), 1, MPI_UINT64_T, 0, comm);
+    if (rank != 0) return true;
+
+    uint64_t rss_maximo = 0, rss_suma = 0;
+    for (uint64_t r : rss_procesos) {
+        rss_maximo = max(rss_maximo, r);
+        rss_suma += r;
+    }
+    uint64_t rss_promedio = rss_suma / size;
+
+    ofstream ofs(archivo);
+    if (!ofs.is_open()) {
+        cerr << "ERROR: No se pudo abrir el archivo de métricas: " << archivo << endl;
+        return false;
+    }
+
+    bool json = Termina_En(archivo, ".json");
+    ofs << fixed << setprecision(6);
+    if (json) {
+        ofs << "{\n  \"operacion\": \"" << operacion << "\",\n  \"modo\": \"" << modo << "\",\n"
+            << "  \"procesos\": " << size << ",\n  \"hilos\": " << hilos << ",\n"
+            << "  \"rss_pico_max_B\": " << rss_maximo << ",\n  \"rss_pico_prom_B\": " << rss_promedio << ",\n"
+            << "  \"rss_pico_B\": [";
+        for (int r = 0; r < size; ++r) ofs << (r > 0 ? ", " : "") << rss_procesos[r];
+        ofs << "],\n  \"fases\": [\n";
+    } else {
+        ofs << "operacion,modo,procesos,hilos,fase,tiempo_min_s,tiempo_max_s,tiempo_prom_s,desbalance,bytes,gb_s,rss_pico_max_B,rss_pico_prom_B\n";
+    }
+
+    for (int f = 0; f < NUM_FASES; ++f) {
+        double promedio = suma[f] / size;
+        // Desbalance: el proceso más lento respecto al promedio (1 = equilibrio perfecto)
+        double desbalance = (promedio > 0) ? maximo[f] / promedio : 1.0;
+        // Rendimiento agregado: la fase termina cuando termina el proceso más lento
+        double gb_s = (maximo[f] > 0) ? bytes_totales[f] / maximo[f] / 1e9 : 0.0;
+        const char* nombre = Nombre((Fase)f);
+
+        if (json) {
+            ofs << "    {\"fase\": \"" << nombre << "\", \"tiempo_min_s\": " << minimo[f]
+                << ", \"tiempo_max_s\": " << maximo[f] << ", \"tiempo_prom_s\": " << promedio
+                << ", \"desbalance\": " << desbalance << ", \"bytes\": " << bytes_totales[f]
+                << ", \"gb_s\": " << gb_s << "}" << (f + 1 < NUM_FASES ? "," : "") << "\n";
+        } else {
+            ofs << operacion << "," << modo << "," << size << "," << hilos << "," << nombre << ","
+                << minimo[f] << "," << maximo[f] << "," << promedio << "," << desbalance << ","
+                << bytes_totales[f] << "," << gb_s << "," << rss_maximo << "," << rss_promedio << "\n";
+        }
+    }
+    if (json) ofs << "  ]\n}\n";
+    return true;
+}
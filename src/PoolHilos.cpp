@@ -0,0 +1,75 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+
+#include "../include/PoolHilos.hpp"
+
+using namespace std;
+
+PoolHilos::PoolHilos(int hilos) : hilos(hilos < 1 ? 1 : hilos) {
+    for (int i = 1; i < this->hilos; ++i) {
+        trabajadores.emplace_back(&PoolHilos::Trabajar, this);
+    }
+}
+
+PoolHilos::~PoolHilos() {
+    {
+        lock_guard<mutex> guardia(candado);
+        terminar = true;
+    }
+    hay_lote.notify_all();
+    for (thread& t : trabajadores) t.join();
+}
+
+void PoolHilos::Ejecutar(size_t tareas, const function<void(size_t)>& tarea) {
+    if (tareas == 0) return;
+    if (trabajadores.empty() || tareas == 1) {
+        for (size_t i = 0; i < tareas; ++i) tarea(i);
+        return;
+    }
+
+    {
+        lock_guard<mutex> guardia(candado);
+        tarea_actual = &tarea;
+        total_tareas = tareas;
+        siguiente_tarea = 0;
+        tareas_pendientes = tareas;
+        generacion++;
+    }
+    hay_lote.notify_all();
+
+    Consumir_Tareas();
+
+    unique_lock<mutex> guardia(candado);
+    lote_terminado.wait(guardia, [this] { return tareas_pendientes == 0; });
+    tarea_actual = nullptr;
+}
+
+// Toma índices del lote actual hasta agotarlos
+void PoolHilos::Consumir_Tareas() {
+    size_t completadas = 0;
+    for (size_t i = siguiente_tarea++; i < total_tareas; i = siguiente_tarea++) {
+        (*tarea_actual)(i);
+        completadas++;
+    }
+    if (completadas == 0) return;
+
+    lock_guard<mutex> guardia(candado);
+    tareas_pendientes -= completadas;
+    if (tareas_pendientes == 0) lote_terminado.notify_all();
+}
+
+void PoolHilos::Trabajar() {
+    unsigned long long vista = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guardia(candado);
+            hay_lote.wait(guardia, [&] { return terminar || generacion != vista; });
+            if (terminar) return;
+            vista = generacion;
+        }
+        Consumir_Tareas();
+    }
+}
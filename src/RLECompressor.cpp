@@ -6,83 +6,621 @@
 
 #include "../include/RLECompressor.hpp"
 #include "../include/Timer.hpp"
+#include "../include/RLEKernels.hpp"
+#include "../include/PoolHilos.hpp"
+#include "../include/ArchivoMapeado.hpp"
+#include "../include/SalidaDirecta.hpp"
+#include "../include/Metricas.hpp"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
 #include <iomanip>
 #include <cstring>
+#include <cstdio>
 #include <numeric>
+#include <functional>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace std;
 
 // --- CONSTANTES DE CODIFICACIÓN (Globales para pruebas) ---
 const uint8_t FLAG_RLE = 0xFF;      // Flag RLE: [0xFF] [CONTEO] [VALOR]
-const uint8_t FLAG_LITERAL = 0xFE;  // Flag Escape: [0xFE] [BYTE_ESCAPADO]
+const uint8_t FLAG_LITERAL = 0xFE;  // Flag Escape: [0xFE] [BYTE_ESCAPADO] (CODEC_RLE_LITERALES: [0xFE] [LONGITUD] [BYTES])
+const uint8_t FLAG_ELEMENTOS = 0xFD;  // CODEC_RLE_ELEMENTOS: [0xFD] [ANCHO] [CONTEO] [ELEMENTO]
+const uint8_t FLAG_PLANOS = 0xFC;     // CODEC_RLE_ELEMENTOS: [0xFC] [ANCHO] [N] [PLANO]... (planos de bytes)
 const size_t RLE_THRESHOLD = 3;     // Umbral mínimo para usar la tupla RLE
-const int FRONTERA_TAG = 100;       // Frontera real del último byte
+const int RECOLECCION_TAG = 102;    // Trozos de la salida local enviados a rank 0 (Recolectar_En_Rank0)
 
-vector<uint8_t> RLECompressor::Comprimir_Local(const vector<uint8_t>& buffer) {
-    vector<uint8_t> salida; 
-    if (buffer.empty()) return salida;
+// Escribe `valor` en LEB128 (7 bits por byte, el bit alto indica que sigue otro byte).
+static size_t Escribir_Varint(uint64_t valor, uint8_t* destino) {
+    size_t n = 0;
+    while (valor >= 0x80) {
+        destino[n++] = (uint8_t)(valor | 0x80);
+        valor >>= 7;
+    }
+    destino[n++] = (uint8_t)valor;
+    return n;
+}
+
+static size_t Longitud_Varint(uint64_t valor) {
+    size_t n = 1;
+    while (valor >= 0x80) {
+        valor >>= 7;
+        n++;
+    }
+    return n;
+}
+
+// Lee el LEB128 que empieza en entrada[k]. Retorna los bytes que ocupa, o 0 si está truncado o
+// excede 64 bits.
+static size_t Leer_Varint(const uint8_t* entrada, size_t k, size_t longitud, uint64_t& valor) {
+    valor = 0;
+    size_t inicio = k;
+    for (int desplazamiento = 0; k < longitud && desplazamiento < 64; desplazamiento += 7) {
+        uint8_t byte = entrada[k++];
+        valor |= (uint64_t)(byte & 0x7F) << desplazamiento;
+        if (!(byte & 0x80)) return k - inicio;
+    }
+    return 0;
+}
+
+// Lee la tupla que empieza en entrada[i] (la bandera FLAG_RLE) según el códec. Retorna los bytes
+// que ocupa la tupla, o 0 si está truncada o su conteo no es válido.
+static size_t Leer_Tupla(const uint8_t* entrada, size_t i, size_t longitud, uint8_t codec, uint64_t& conteo) {
+    if (codec == RLEContainer::CODEC_RLE) {
+        if (i + 2 >= longitud) return 0;
+        conteo = entrada[i + 1];
+        return 3;
+    }
+    size_t bytes = Leer_Varint(entrada, i + 1, longitud, conteo);
+    return (bytes > 0 && i + 1 + bytes < longitud) ? bytes + 2 : 0;
+}
+
+// Lee la cabecera del bloque de literales que empieza en entrada[i] (CODEC_RLE_LITERALES). Retorna
+// los bytes de la cabecera, o 0 si el bloque está truncado.
+static size_t Leer_Literales(const uint8_t* entrada, size_t i, size_t longitud, uint64_t& n) {
+    size_t bytes = Leer_Varint(entrada, i + 1, longitud, n);
+    if (bytes == 0 || n > longitud - (i + 1 + bytes)) return 0;
+    return bytes + 1;
+}
+
+// Emite `n` bytes de `datos` en bloques [FLAG_LITERAL][longitud LEB128][bytes] de a lo más
+// MAX_BLOQUE_LITERALES. Retorna el final de lo escrito.
+static uint8_t* Emitir_Literales(const uint8_t* datos, size_t n, uint8_t* escritura) {
+    while (n > 0) {
+        size_t bloque = min(n, RLECompressor::MAX_BLOQUE_LITERALES);
+        *escritura++ = FLAG_LITERAL;
+        escritura += Escribir_Varint(bloque, escritura);
+        memcpy(escritura, datos, bloque);
+        escritura += bloque;
+        datos += bloque;
+        n -= bloque;
+    }
+    return escritura;
+}
+
+// Codificación de CODEC_RLE_LITERALES: las corridas de RLE_THRESHOLD o más son tuplas LEB128 y todo
+// lo demás va en bloques de literales copiados en bloque, sin escapar las banderas. No guarda estado:
+// una corrida o un bloque que cruza el final de `datos` se parte en dos.
+static size_t Comprimir_Literales(const uint8_t* datos, size_t longitud, uint8_t* salida) {
+    uint8_t* escritura = salida;
+    size_t pendientes = 0;  // Inicio de los literales aún no emitidos
+    size_t i = 0;
+    while (i < longitud) {
+        // Longitud_Literales también se detiene en las banderas, que aquí son literales comunes
+        i += RLEKernels::Longitud_Literales(datos + i, longitud - i);
+        if (i == longitud) break;
+        size_t corrida = RLEKernels::Longitud_Corrida(datos + i, longitud - i, datos[i]);
+        if (corrida >= RLE_THRESHOLD) {
+            escritura = Emitir_Literales(datos + pendientes, i - pendientes, escritura);
+            *escritura++ = FLAG_RLE;
+            escritura += Escribir_Varint(corrida, escritura);
+            *escritura++ = datos[i];
+            pendientes = i + corrida;
+        }
+        i += corrida;
+    }
+    escritura = Emitir_Literales(datos + pendientes, longitud - pendientes, escritura);
+    return escritura - salida;
+}
+
+// --- Códec por elementos (CODEC_RLE_ELEMENTOS) ---
+// Las plantillas reciben el ancho W en compilación (1, 2, 4 u 8: las comparaciones y copias de un
+// elemento se reducen a una carga y un almacenamiento); con W == 0 usan `ancho` en ejecución, para
+// registros de cualquier tamaño.
+
+// Número de elementos iniciales iguales al primero (a lo más `n`).
+template <size_t W>
+static size_t Corrida_Elementos(const uint8_t* datos, size_t n, size_t ancho) {
+    const size_t w = W ? W : ancho;
+    size_t k = 1;
+    while (k < n && memcmp(datos + k * w, datos, w) == 0) k++;
+    return k;
+}
+
+template <size_t W>
+static void Repetir_Elemento(uint8_t* destino, const uint8_t* elemento, uint64_t n, size_t ancho) {
+    const size_t w = W ? W : ancho;
+    for (uint64_t k = 0; k < n; ++k) memcpy(destino + k * w, elemento, w);
+}
+
+// Transposición de `n` elementos a `w` planos de `n` bytes (el plano k tiene el byte k de cada elemento).
+template <size_t W>
+static void Separar_Planos(const uint8_t* datos, size_t n, size_t ancho, uint8_t* planos) {
+    const size_t w = W ? W : ancho;
+    for (size_t j = 0; j < n; ++j) {
+        for (size_t k = 0; k < w; ++k) planos[k * n + j] = datos[j * w + k];
+    }
+}
+
+template <size_t W>
+static void Unir_Plano(const uint8_t* plano, size_t n, size_t ancho, size_t k, uint8_t* datos) {
+    const size_t w = W ? W : ancho;
+    for (size_t j = 0; j < n; ++j) datos[j * w + k] = plano[j];
+}
+
+// Corridas de elementos como tuplas [FLAG_ELEMENTOS][ancho][conteo LEB128][elemento] (solo si ocupan
+// menos que los elementos que reemplazan) y el resto, incluidos los bytes finales que no completan
+// un elemento, en bloques de literales.
+template <size_t W>
+static size_t Comprimir_Elementos_Ancho(const uint8_t* datos, size_t longitud, size_t ancho, uint8_t* salida) {
+    const size_t w = W ? W : ancho;
+    const size_t n = longitud / w;
+    uint8_t* escritura = salida;
+    size_t pendientes = 0;
+    size_t i = 0;
+    while (i < n) {
+        size_t corrida = Corrida_Elementos<W>(datos + i * w, n - i, w);
+        if (corrida > 1 && 2 + Longitud_Varint(corrida) + w < corrida * w) {
+            escritura = Emitir_Literales(datos + pendientes, i * w - pendientes, escritura);
+            *escritura++ = FLAG_ELEMENTOS;
+            *escritura++ = (uint8_t)w;
+            escritura += Escribir_Varint(corrida, escritura);
+            memcpy(escritura, datos + i * w, w);
+            escritura += w;
+            pendientes = (i + corrida) * w;
+        }
+        i += corrida;
+    }
+    escritura = Emitir_Literales(datos + pendientes, longitud - pendientes, escritura);
+    return escritura - salida;
+}
+
+// Con planos: cada grupo de ELEMENTOS_POR_GRUPO elementos se transpone y cada plano se codifica como
+// CODEC_RLE_LITERALES, en un token [FLAG_PLANOS][ancho][n LEB128][plano 0]...[plano w - 1]. Si el
+// grupo no ocupa menos así, se emite con Comprimir_Elementos_Ancho.
+template <size_t W>
+static size_t Comprimir_Planos_Ancho(const uint8_t* datos, size_t longitud, size_t ancho, uint8_t* salida) {
+    const size_t w = W ? W : ancho;
+    const size_t n = longitud / w;
+    uint8_t* escritura = salida;
+    vector<uint8_t> planos, candidato;
+    for (size_t e = 0; e < n; e += RLECompressor::ELEMENTOS_POR_GRUPO) {
+        size_t g = min(n - e, RLECompressor::ELEMENTOS_POR_GRUPO);
+        const uint8_t* grupo = datos + e * w;
+        planos.resize(g * w);
+        Separar_Planos<W>(grupo, g, w, planos.data());
+
+        candidato.resize(2 + 10 + w * RLECompressor::MaxCompressedSize(g, RLEContainer::CODEC_RLE_LITERALES));
+        size_t bytes = 0;
+        candidato[bytes++] = FLAG_PLANOS;
+        candidato[bytes++] = (uint8_t)w;
+        bytes += Escribir_Varint(g, candidato.data() + bytes);
+        for (size_t k = 0; k < w; ++k) {
+            bytes += Comprimir_Literales(planos.data() + k * g, g, candidato.data() + bytes);
+        }
+
+        size_t directo = Comprimir_Elementos_Ancho<W>(grupo, g * w, w, escritura);
+        if (bytes < directo) {
+            memcpy(escritura, candidato.data(), bytes);
+            directo = bytes;
+        }
+        escritura += directo;
+    }
+    escritura = Emitir_Literales(datos + n * w, longitud - n * w, escritura);
+    return escritura - salida;
+}
+
+template <size_t W>
+static size_t Comprimir_Elementos_W(const uint8_t* datos, size_t longitud, size_t ancho, bool planos, uint8_t* salida) {
+    return planos ? Comprimir_Planos_Ancho<W>(datos, longitud, ancho, salida)
+                  : Comprimir_Elementos_Ancho<W>(datos, longitud, ancho, salida);
+}
+
+static size_t Comprimir_Elementos(const uint8_t* datos, size_t longitud, size_t ancho, bool planos, uint8_t* salida) {
+    switch (ancho) {
+        case 0:
+        case 1: return Comprimir_Literales(datos, longitud, salida);
+        case 2: return Comprimir_Elementos_W<2>(datos, longitud, ancho, planos, salida);
+        case 4: return Comprimir_Elementos_W<4>(datos, longitud, ancho, planos, salida);
+        case 8: return Comprimir_Elementos_W<8>(datos, longitud, ancho, planos, salida);
+        default: return Comprimir_Elementos_W<0>(datos, longitud, ancho, planos, salida);
+    }
+}
 
+static void Repetir_Elementos(uint8_t* destino, const uint8_t* elemento, uint64_t n, size_t ancho) {
+    switch (ancho) {
+        case 1: memset(destino, elemento[0], n); break;
+        case 2: Repetir_Elemento<2>(destino, elemento, n, ancho); break;
+        case 4: Repetir_Elemento<4>(destino, elemento, n, ancho); break;
+        case 8: Repetir_Elemento<8>(destino, elemento, n, ancho); break;
+        default: Repetir_Elemento<0>(destino, elemento, n, ancho); break;
+    }
+}
+
+static void Unir_Planos(const uint8_t* plano, size_t n, size_t ancho, size_t k, uint8_t* datos) {
+    switch (ancho) {
+        case 2: Unir_Plano<2>(plano, n, ancho, k, datos); break;
+        case 4: Unir_Plano<4>(plano, n, ancho, k, datos); break;
+        case 8: Unir_Plano<8>(plano, n, ancho, k, datos); break;
+        default: Unir_Plano<0>(plano, n, ancho, k, datos); break;
+    }
+}
+
+// Lee la cabecera [bandera][ancho][n LEB128] de una tupla de elementos o de un token de planos.
+// Retorna sus bytes, o 0 si está truncada o el ancho es 0.
+static size_t Leer_Cabecera_Elementos(const uint8_t* entrada, size_t i, size_t longitud, size_t& ancho, uint64_t& n) {
+    if (i + 1 >= longitud || entrada[i + 1] == 0) return 0;
+    ancho = entrada[i + 1];
+    size_t bytes = Leer_Varint(entrada, i + 2, longitud, n);
+    return bytes > 0 ? bytes + 2 : 0;
+}
+
+// Decodifica un plano (tokens de CODEC_RLE_LITERALES) hasta producir exactamente `n` bytes en `plano`
+// (o solo lo recorre si `plano` es nulo). Retorna los bytes de entrada que ocupa, o 0 si es inválido.
+static size_t Decodificar_Plano(const uint8_t* entrada, size_t longitud, uint8_t* plano, uint64_t n) {
     size_t i = 0;
-    while (i < buffer.size()) {
-        uint8_t valor_actual = buffer[i];
-        size_t j = i;
-        
-        while (j < buffer.size() && buffer[j] == valor_actual && (j - i) < 255) {
-            j++;
-        }
-        size_t conteo = j - i;
-
-        if (conteo >= RLE_THRESHOLD) {
-            salida.push_back(FLAG_RLE); 
-            salida.push_back((uint8_t)conteo); 
-            salida.push_back(valor_actual); 
+    uint64_t escritos = 0;
+    while (escritos < n) {
+        if (i >= longitud) return 0;
+        uint64_t conteo;
+        size_t cabecera;
+        if (entrada[i] == FLAG_RLE) {
+            cabecera = Leer_Tupla(entrada, i, longitud, RLEContainer::CODEC_RLE_LITERALES, conteo);
+            if (cabecera == 0 || conteo > n - escritos) return 0;
+            if (plano) memset(plano + escritos, entrada[i + cabecera - 1], conteo);
+        } else if (entrada[i] == FLAG_LITERAL) {
+            cabecera = Leer_Literales(entrada, i, longitud, conteo);
+            if (cabecera == 0 || conteo > n - escritos) return 0;
+            if (plano) memcpy(plano + escritos, entrada + i + cabecera, conteo);
+            cabecera += conteo;
         } else {
-            for (size_t k = 0; k < conteo; ++k) {
-                uint8_t literal_byte = buffer[i + k];
-                
-                if (literal_byte == FLAG_RLE || literal_byte == FLAG_LITERAL) {
-                    salida.push_back(FLAG_LITERAL);
-                }
-                salida.push_back(literal_byte); 
+            return 0;
+        }
+        escritos += conteo;
+        i += cabecera;
+    }
+    return i;
+}
+
+// Decodifica (o recorre, si `salida` es nula) los planos de un token FLAG_PLANOS de `n` elementos.
+// Retorna los bytes de entrada que ocupan, o 0 si son inválidos.
+static size_t Decodificar_Planos(const uint8_t* entrada, size_t longitud, size_t ancho, uint64_t n, uint8_t* salida) {
+    vector<uint8_t> plano(salida ? n : 0);
+    size_t i = 0;
+    for (size_t k = 0; k < ancho; ++k) {
+        size_t bytes = Decodificar_Plano(entrada + i, longitud - i, salida ? plano.data() : nullptr, n);
+        if (bytes == 0 && n > 0) return 0;
+        if (salida) Unir_Planos(plano.data(), n, ancho, k, salida);
+        i += bytes;
+    }
+    return i;
+}
+
+// Bytes que ocupa el token FLAG_ELEMENTOS o FLAG_PLANOS que empieza en entrada[i], o 0 si es inválido.
+// En `original` deja los bytes que produce al descomprimirse.
+static size_t Longitud_Token_Elementos(const uint8_t* entrada, size_t i, size_t longitud, uint64_t& original) {
+    size_t ancho;
+    uint64_t n;
+    size_t cabecera = Leer_Cabecera_Elementos(entrada, i, longitud, ancho, n);
+    if (cabecera == 0) return 0;
+    original = n * ancho;
+    size_t resto = longitud - i - cabecera;
+    if (entrada[i] == FLAG_ELEMENTOS) return (ancho <= resto) ? cabecera + ancho : 0;
+    size_t bytes = Decodificar_Planos(entrada + i + cabecera, resto, ancho, n, nullptr);
+    return (bytes > 0) ? cabecera + bytes : 0;
+}
+
+vector<uint8_t> RLECompressor::Comprimir_Local(const vector<uint8_t>& buffer, uint8_t codec, size_t elemento, bool planos) {
+    vector<uint8_t> salida(MaxCompressedSize(buffer.size(), codec));
+    salida.resize(Comprimir_Local(buffer.data(), buffer.size(), salida.data(), salida.size(), codec, elemento, planos));
+    return salida;
+}
+
+size_t RLECompressor::Comprimir_Local(const uint8_t* entrada, size_t longitud, uint8_t* salida, size_t capacidad, uint8_t codec, size_t elemento, bool planos) {
+    if (capacidad < MaxCompressedSize(longitud, codec)) return SIN_CAPACIDAD;
+
+    Corrida corrida;
+    corrida.codec = codec;
+    corrida.elemento = elemento;
+    corrida.planos = planos;
+    size_t escritos = Comprimir_Ventana(entrada, longitud, corrida, salida);
+    return escritos + Cerrar_Corrida(corrida, salida + escritos);
+}
+
+void RLECompressor::Comprimir_Ventana(const uint8_t* datos, size_t longitud, Corrida& corrida, vector<uint8_t>& salida) {
+    size_t inicio = salida.size();
+    salida.resize(inicio + MaxCompressedSize(longitud, corrida.codec) + MAX_CIERRE_CORRIDA);
+    salida.resize(inicio + Comprimir_Ventana(datos, longitud, corrida, salida.data() + inicio));
+}
+
+size_t RLECompressor::Comprimir_Ventana(const uint8_t* datos, size_t longitud, Corrida& corrida, uint8_t* salida) {
+    if (corrida.codec == RLEContainer::CODEC_RLE_LITERALES) return Comprimir_Literales(datos, longitud, salida);
+    if (corrida.codec == RLEContainer::CODEC_RLE_ELEMENTOS) return Comprimir_Elementos(datos, longitud, corrida.elemento, corrida.planos, salida);
+
+    uint8_t* escritura = salida;
+    const uint64_t limite = Conteo_Maximo(corrida.codec);
+    size_t i = 0;
+    while (i < longitud) {
+        uint8_t valor_actual = datos[i];
+
+        if (corrida.conteo > 0 && valor_actual != corrida.valor) {
+            escritura += Cerrar_Corrida(corrida, escritura);
+        }
+
+        // Sin corrida abierta: los tramos sin banderas ni corridas se copian tal cual
+        if (corrida.conteo == 0) {
+            size_t literales = RLEKernels::Longitud_Literales(datos + i, longitud - i);
+            if (literales > 0) {
+                memcpy(escritura, datos + i, literales);
+                escritura += literales;
+                i += literales;
+                continue;
+            }
+        }
+        corrida.valor = valor_actual;
+
+        size_t j = i + RLEKernels::Longitud_Corrida(datos + i, min<uint64_t>(longitud - i, limite - corrida.conteo), valor_actual);
+        corrida.conteo += j - i;
+        i = j;
+
+        // Una corrida de Conteo_Maximo ya no puede crecer: se emite y la siguiente empieza de cero
+        if (corrida.conteo == limite) {
+            escritura += Cerrar_Corrida(corrida, escritura);
+        }
+    }
+    return escritura - salida;
+}
+
+void RLECompressor::Agregar_Corrida(Corrida& corrida, uint8_t valor, uint64_t n, vector<uint8_t>& salida) {
+    if (corrida.conteo > 0 && corrida.valor != valor) {
+        Cerrar_Corrida(corrida, salida);
+    }
+    corrida.valor = valor;
+    const uint64_t limite = Conteo_Maximo(corrida.codec);
+    while (n > 0) {
+        size_t agregados = min<uint64_t>(n, limite - corrida.conteo);
+        corrida.conteo += agregados;
+        n -= agregados;
+        if (corrida.conteo == limite) Cerrar_Corrida(corrida, salida);
+    }
+}
+
+void RLECompressor::Comprimir_Ventana_Paralela(PoolHilos& pool, const uint8_t* datos, size_t longitud, Corrida& corrida,
+                                               vector<uint8_t>& salida, vector<vector<uint8_t>>& parciales) {
+    size_t partes = min<size_t>(pool.Hilos(), longitud / TAMANO_MINIMO_PARTE);
+    if (partes <= 1) {
+        Comprimir_Ventana(datos, longitud, corrida, salida);
+        return;
+    }
+
+    // Cada parte separa su corrida inicial (que puede continuar la de la parte anterior) y comprime
+    // el resto desde cero: el resto empieza en un cambio de valor, así que sus tokens no dependen
+    // de lo que haya antes. Su corrida final queda abierta para la unión.
+    struct Parte {
+        const uint8_t* inicio;
+        size_t longitud;
+        size_t lider = 0;
+        size_t escritos = 0;
+        Corrida final;
+    };
+    // Los cortes caen en fronteras de elemento (corrida.elemento es 1 salvo en CODEC_RLE_ELEMENTOS)
+    auto corte = [&](size_t k) {
+        size_t c = longitud * k / partes;
+        return (k == partes) ? longitud : c - c % corrida.elemento;
+    };
+    vector<Parte> info(partes);
+    for (size_t k = 0; k < partes; ++k) {
+        info[k].inicio = datos + corte(k);
+        info[k].longitud = corte(k + 1) - corte(k);
+        info[k].final = corrida;
+        info[k].final.conteo = 0;
+    }
+    if (parciales.size() < partes) parciales.resize(partes);
+
+    // Con literales en bloques no hay corrida abierta que continuar: cada parte se codifica completa
+    bool independientes = Literales_En_Bloques(corrida.codec);
+    pool.Ejecutar(partes, [&](size_t k) {
+        Parte& parte = info[k];
+        parte.lider = independientes ? 0 : RLEKernels::Longitud_Corrida(parte.inicio, parte.longitud, parte.inicio[0]);
+        size_t resto = parte.longitud - parte.lider;
+        if (resto == 0) return;
+
+        vector<uint8_t>& buffer = parciales[k];
+        size_t necesario = MaxCompressedSize(resto, corrida.codec) + MAX_CIERRE_CORRIDA;
+        if (buffer.size() < necesario) buffer.resize(necesario);
+        parte.escritos = Comprimir_Ventana(parte.inicio + parte.lider, resto, parte.final, buffer.data());
+    });
+
+    // Unión en orden, igual que la corrección de fronteras entre procesos pero en memoria compartida
+    for (size_t k = 0; k < partes; ++k) {
+        const Parte& parte = info[k];
+        Agregar_Corrida(corrida, parte.inicio[0], parte.lider, salida);
+        if (parte.lider == parte.longitud) continue;
+
+        Cerrar_Corrida(corrida, salida);
+        salida.insert(salida.end(), parciales[k].data(), parciales[k].data() + parte.escritos);
+        corrida = parte.final;
+    }
+}
+
+void RLECompressor::Cerrar_Corrida(Corrida& corrida, vector<uint8_t>& salida) {
+    uint8_t tokens[MAX_CIERRE_CORRIDA];
+    size_t n = Cerrar_Corrida(corrida, tokens);
+    salida.insert(salida.end(), tokens, tokens + n);
+}
+
+size_t RLECompressor::Cerrar_Corrida(Corrida& corrida, uint8_t* salida) {
+    size_t escritos = 0;
+    if (corrida.conteo >= RLE_THRESHOLD) {
+        salida[escritos++] = FLAG_RLE; 
+        if (corrida.codec != RLEContainer::CODEC_RLE) {
+            escritos += Escribir_Varint(corrida.conteo, salida + escritos);
+        } else {
+            salida[escritos++] = (uint8_t)corrida.conteo; 
+        }
+        salida[escritos++] = corrida.valor; 
+    } else {
+        for (size_t k = 0; k < corrida.conteo; ++k) {
+            if (corrida.valor == FLAG_RLE || corrida.valor == FLAG_LITERAL) {
+                salida[escritos++] = FLAG_LITERAL;
             }
+            salida[escritos++] = corrida.valor; 
         }
+    }
+    corrida.conteo = 0;
+    return escritos;
+}
+
+void RLECompressor::Actualizar_Frontera(Frontera& frontera, const uint8_t* datos, size_t longitud) {
+    if (longitud == 0) return;
+    frontera.crc = RLEKernels::CRC32C(datos, longitud, frontera.crc);
+    if (frontera.longitud == 0) frontera.primer_byte = datos[0];
+    size_t lider = RLEKernels::Longitud_Corrida(datos, longitud, datos[0]);
+
+    // La corrida inicial sigue abierta mientras todos los bytes vistos sean iguales al primero
+    if (frontera.corrida_inicial == frontera.longitud && datos[0] == frontera.primer_byte) {
+        frontera.corrida_inicial += lider;
+    }
 
-        i += conteo;
+    // Corrida final: si la ventana es uniforme puede continuar la de las ventanas anteriores
+    if (lider == longitud) {
+        bool continua = frontera.longitud > 0 && datos[0] == frontera.ultimo_byte;
+        frontera.corrida_final = (continua ? frontera.corrida_final : 0) + longitud;
+    } else {
+        size_t k = 1;
+        while (datos[longitud - 1 - k] == datos[longitud - 1]) k++;
+        frontera.corrida_final = k;
     }
+
+    frontera.ultimo_byte = datos[longitud - 1];
+    frontera.longitud += longitud;
+}
+
+vector<uint8_t> RLECompressor::Descomprimir_Local(const vector<uint8_t>& compressed_buffer, uint8_t codec) {
+    vector<uint8_t> salida(Longitud_Descomprimida(compressed_buffer.data(), compressed_buffer.size(), codec));
+    Descomprimir_Local(compressed_buffer.data(), compressed_buffer.size(), salida.data(), salida.size(), codec);
     return salida;
 }
 
-vector<uint8_t> RLECompressor::Descomprimir_Local(const vector<uint8_t>& compressed_buffer) {
-    vector<uint8_t> salida;
+size_t RLECompressor::Descomprimir_Local(const uint8_t* entrada, size_t longitud, uint8_t* salida, size_t capacidad, uint8_t codec) {
+    size_t escritos = 0;
     size_t i = 0;
 
-    while (i < compressed_buffer.size()) {
-        uint8_t byte = compressed_buffer[i];
+    while (i < longitud) {
+        uint8_t byte = entrada[i];
 
         if (byte == FLAG_RLE) {
-            if (i + 2 >= compressed_buffer.size()) break; 
+            uint64_t conteo;
+            size_t tupla = Leer_Tupla(entrada, i, longitud, codec, conteo);
+            if (tupla == 0) break; 
             
-            uint8_t conteo = compressed_buffer[i + 1];
-            uint8_t valor = compressed_buffer[i + 2];
-            
-            for (int k = 0; k < conteo; ++k) salida.push_back(valor);
-            i += 3;
+            if (conteo > capacidad - escritos) return SIN_CAPACIDAD;
+
+            memset(salida + escritos, entrada[i + tupla - 1], conteo);
+            escritos += conteo;
+            i += tupla;
+
+        } else if (byte == FLAG_LITERAL && Literales_En_Bloques(codec)) {
+            uint64_t n;
+            size_t cabecera = Leer_Literales(entrada, i, longitud, n);
+            if (cabecera == 0) break;
+            if (n > capacidad - escritos) return SIN_CAPACIDAD;
+
+            memcpy(salida + escritos, entrada + i + cabecera, n);
+            escritos += n;
+            i += cabecera + n;
 
         } else if (byte == FLAG_LITERAL) {
-            if (i + 1 >= compressed_buffer.size()) break;
+            if (i + 1 >= longitud) break;
+            if (escritos == capacidad) return SIN_CAPACIDAD;
             
-            salida.push_back(compressed_buffer[i + 1]);
+            salida[escritos++] = entrada[i + 1];
             i += 2;
+
+        } else if ((byte == FLAG_ELEMENTOS || byte == FLAG_PLANOS) && codec == RLEContainer::CODEC_RLE_ELEMENTOS) {
+            size_t ancho;
+            uint64_t n;
+            size_t cabecera = Leer_Cabecera_Elementos(entrada, i, longitud, ancho, n);
+            if (cabecera == 0) break;
+            if (n > (capacidad - escritos) / ancho) return SIN_CAPACIDAD;
+
+            size_t bytes;
+            if (byte == FLAG_ELEMENTOS) {
+                bytes = (ancho <= longitud - i - cabecera) ? ancho : 0;
+                if (bytes > 0) Repetir_Elementos(salida + escritos, entrada + i + cabecera, n, ancho);
+            } else {
+                bytes = Decodificar_Planos(entrada + i + cabecera, longitud - i - cabecera, ancho, n, salida + escritos);
+            }
+            if (bytes == 0) break;
+            escritos += n * ancho;
+            i += cabecera + bytes;
         }
         else {
-            salida.push_back(byte);
-            i += 1;
+            // Con literales en bloques un byte suelto es un flujo inválido
+            if (Literales_En_Bloques(codec)) break;
+
+            // Tramo máximo de literales sin escapar: se copia en bloque
+            size_t literales = RLEKernels::Longitud_Sin_Banderas(entrada + i, longitud - i);
+            if (literales > capacidad - escritos) return SIN_CAPACIDAD;
+
+            memcpy(salida + escritos, entrada + i, literales);
+            escritos += literales;
+            i += literales;
         }
     }
-    return salida;
+    return escritos;
+}
+
+uint64_t RLECompressor::Longitud_Descomprimida(const uint8_t* entrada, size_t longitud, uint8_t codec) {
+    uint64_t total = 0;
+    size_t i = 0;
+
+    // Mismo recorrido de tokens que Descomprimir_Local (un token truncado termina el flujo)
+    while (i < longitud) {
+        uint8_t byte = entrada[i];
+        if (byte == FLAG_RLE) {
+            uint64_t conteo;
+            size_t tupla = Leer_Tupla(entrada, i, longitud, codec, conteo);
+            if (tupla == 0) break;
+            total += conteo;
+            i += tupla;
+        } else if (byte == FLAG_LITERAL && Literales_En_Bloques(codec)) {
+            uint64_t n;
+            size_t cabecera = Leer_Literales(entrada, i, longitud, n);
+            if (cabecera == 0) break;
+            total += n;
+            i += cabecera + n;
+        } else if (byte == FLAG_LITERAL) {
+            if (i + 1 >= longitud) break;
+            total += 1;
+            i += 2;
+        } else if ((byte == FLAG_ELEMENTOS || byte == FLAG_PLANOS) && codec == RLEContainer::CODEC_RLE_ELEMENTOS) {
+            uint64_t n;
+            size_t token = Longitud_Token_Elementos(entrada, i, longitud, n);
+            if (token == 0) break;
+            total += n;
+            i += token;
+        } else {
+            if (Literales_En_Bloques(codec)) break;
+            size_t literales = RLEKernels::Longitud_Sin_Banderas(entrada + i, longitud - i);
+            total += literales;
+            i += literales;
+        }
+    }
+    return total;
 }
 
 vector<uint8_t> Comprimir_Local_Test(const vector<uint8_t>& buffer) {
@@ -92,6 +630,397 @@ vector<uint8_t> Descomprimir_Local_Test(const vector<uint8_t>& compressed_buffer
     return RLECompressor::Descomprimir_Local(compressed_buffer);
 }
 
+// CRC32C de `n` repeticiones de `patron` (de `ancho` bytes) a continuación de `crc`. Las repeticiones
+// cortas se calculan sobre un buffer con el patrón repetido; las largas duplican el CRC de ese buffer
+// con CRC32C_Combinar (O(log n)), sin recorrer los bytes.
+static uint32_t Extender_CRC_Repetido(uint32_t crc, const uint8_t* patron, size_t ancho, uint64_t n) {
+    uint8_t buffer[1024];
+    const size_t por_buffer = sizeof(buffer) / ancho;  // ancho <= 255: al menos 4 repeticiones
+    for (size_t k = 0; k < min<uint64_t>(n, por_buffer); ++k) memcpy(buffer + k * ancho, patron, ancho);
+
+    if (n > 4 * por_buffer) {
+        const size_t bytes_buffer = por_buffer * ancho;
+        uint32_t potencia = RLEKernels::CRC32C(buffer, bytes_buffer);
+        uint64_t longitud_potencia = bytes_buffer;
+        uint32_t acumulado = 0;
+        uint64_t longitud_acumulada = 0;
+        for (uint64_t k = n / por_buffer; k > 0; k >>= 1) {
+            if (k & 1) {
+                acumulado = RLEKernels::CRC32C_Combinar(acumulado, potencia, longitud_potencia);
+                longitud_acumulada += longitud_potencia;
+            }
+            if (k > 1) {
+                potencia = RLEKernels::CRC32C_Combinar(potencia, potencia, longitud_potencia);
+                longitud_potencia *= 2;
+            }
+        }
+        crc = RLEKernels::CRC32C_Combinar(crc, acumulado, longitud_acumulada);
+        n %= por_buffer;
+    }
+    while (n > 0) {
+        size_t m = min<uint64_t>(n, por_buffer);
+        crc = RLEKernels::CRC32C(buffer, m * ancho, crc);
+        n -= m;
+    }
+    return crc;
+}
+
+// CRC32C de los bytes que produce el token válido de elementos o de planos en entrada[i], a
+// continuación de `crc`. Los planos se decodifican aparte (la transposición no se puede evitar).
+static uint32_t Extender_CRC_Elementos(uint32_t crc, const uint8_t* entrada, size_t i, size_t longitud) {
+    size_t ancho = 1;
+    uint64_t n = 0;
+    size_t cabecera = Leer_Cabecera_Elementos(entrada, i, longitud, ancho, n);
+    if (entrada[i] == FLAG_ELEMENTOS) return Extender_CRC_Repetido(crc, entrada + i + cabecera, ancho, n);
+
+    vector<uint8_t> datos(n * ancho);
+    Decodificar_Planos(entrada + i + cabecera, longitud - i - cabecera, ancho, n, datos.data());
+    return RLEKernels::CRC32C(datos.data(), datos.size(), crc);
+}
+
+vector<RLEContainer::Bloque> RLECompressor::Dividir_En_Bloques(const uint8_t* carga, size_t longitud, size_t tamano_objetivo, uint8_t codec) {
+    vector<RLEContainer::Bloque> bloques;
+    size_t inicio = 0;
+    size_t i = 0;
+    uint64_t original = 0;
+    uint32_t crc = 0;
+
+    while (i < longitud) {
+        uint8_t byte = carga[i];
+
+        // Mismo recorrido de tokens que Descomprimir_Local (un token truncado no produce bytes)
+        if (byte == FLAG_RLE) {
+            uint64_t conteo;
+            size_t tupla = Leer_Tupla(carga, i, longitud, codec, conteo);
+            if (tupla > 0) {
+                original += conteo;
+                crc = Extender_CRC_Repetido(crc, carga + i + tupla - 1, 1, conteo);
+            }
+            i = (tupla > 0) ? i + tupla : longitud;
+        } else if (byte == FLAG_LITERAL && Literales_En_Bloques(codec)) {
+            uint64_t n;
+            size_t cabecera = Leer_Literales(carga, i, longitud, n);
+            if (cabecera > 0) {
+                original += n;
+                crc = RLEKernels::CRC32C(carga + i + cabecera, n, crc);
+            }
+            i = (cabecera > 0) ? i + cabecera + n : longitud;
+        } else if (byte == FLAG_LITERAL) {
+            if (i + 1 < longitud) {
+                original += 1;
+                crc = RLEKernels::CRC32C(carga + i + 1, 1, crc);
+            }
+            i = min(i + 2, longitud);
+        } else if ((byte == FLAG_ELEMENTOS || byte == FLAG_PLANOS) && codec == RLEContainer::CODEC_RLE_ELEMENTOS) {
+            uint64_t n;
+            size_t token = Longitud_Token_Elementos(carga, i, longitud, n);
+            if (token > 0) {
+                original += n;
+                crc = Extender_CRC_Elementos(crc, carga, i, longitud);
+            }
+            i = (token > 0) ? i + token : longitud;
+        } else if (Literales_En_Bloques(codec)) {
+            i = longitud;
+        } else {
+            // Tramo de literales sin banderas, sin pasar del tamaño objetivo
+            uint64_t limite = min<uint64_t>(longitud - i, max<uint64_t>(tamano_objetivo - original, 1));
+            size_t n = RLEKernels::Longitud_Sin_Banderas(carga + i, limite);
+            crc = RLEKernels::CRC32C(carga + i, n, crc);
+            original += n;
+            i += n;
+        }
+
+        if (original >= tamano_objetivo || i == longitud) {
+            RLEContainer::Bloque bloque;
+            bloque.longitud_comprimida = i - inicio;
+            bloque.longitud_original = original;
+            bloque.checksum = crc;
+            bloques.push_back(bloque);
+
+            inicio = i;
+            original = 0;
+            crc = 0;
+        }
+    }
+    return bloques;
+}
+
+// CRC32C de los bytes originales de `bloques` consecutivos, combinando sus checksums.
+static uint32_t Combinar_Checksums(const vector<RLEContainer::Bloque>& bloques, uint32_t crc = 0) {
+    for (const RLEContainer::Bloque& b : bloques) crc = RLEKernels::CRC32C_Combinar(crc, b.checksum, b.longitud_original);
+    return crc;
+}
+
+size_t RLECompressor::Almacenar_Bloques(uint8_t* carga, vector<RLEContainer::Bloque>& bloques, uint8_t codec) {
+    vector<uint8_t> original;
+    size_t leido = 0, escrito = 0;
+    for (RLEContainer::Bloque& b : bloques) {
+        if (b.tipo == RLEContainer::BLOQUE_RLE && b.longitud_comprimida >= b.longitud_original) {
+            // El destino puede solaparse con la carga del propio bloque: se decodifica aparte
+            original.resize(b.longitud_original);
+            Descomprimir_Local(carga + leido, b.longitud_comprimida, original.data(), original.size(), codec);
+            memcpy(carga + escrito, original.data(), original.size());
+            leido += b.longitud_comprimida;
+            b.tipo = RLEContainer::BLOQUE_ALMACENADO;
+            b.longitud_comprimida = b.longitud_original;
+        } else {
+            memmove(carga + escrito, carga + leido, b.longitud_comprimida);
+            leido += b.longitud_comprimida;
+        }
+        escrito += b.longitud_comprimida;
+    }
+    return escrito;
+}
+
+bool RLECompressor::Descomprimir_Bloque(const RLEContainer::Bloque& bloque, const uint8_t* carga, uint8_t* salida, uint8_t codec, bool verificar) {
+    if (bloque.tipo == RLEContainer::BLOQUE_ALMACENADO) {
+        if (bloque.longitud_comprimida != bloque.longitud_original) return false;
+        memcpy(salida, carga, bloque.longitud_original);
+    } else if (bloque.tipo != RLEContainer::BLOQUE_RLE ||
+               Descomprimir_Local(carga, bloque.longitud_comprimida, salida, bloque.longitud_original, codec) != bloque.longitud_original) {
+        return false;
+    }
+    // El bloque recién escrito sigue en caché: la verificación cuesta poco más que releerlo
+    return !verificar || RLEKernels::CRC32C(salida, bloque.longitud_original) == bloque.checksum;
+}
+
+bool RLECompressor::Extraer_Tokens(const vector<uint8_t>& archivo, vector<uint8_t>& tokens) {
+    RLEContainer::Cabecera cabecera;
+    vector<RLEContainer::Bloque> bloques;
+    if (!RLEContainer::Parsear(archivo.data(), archivo.size(), cabecera, bloques)) return false;
+
+    tokens.clear();
+    for (const RLEContainer::Bloque& b : bloques) {
+        const uint8_t* inicio = archivo.data() + b.offset + RLEContainer::TAMANO_REGISTRO;
+        if (b.tipo == RLEContainer::BLOQUE_ALMACENADO) {
+            vector<uint8_t> codificado = Comprimir_Local(vector<uint8_t>(inicio, inicio + b.longitud_comprimida), cabecera.codec);
+            tokens.insert(tokens.end(), codificado.begin(), codificado.end());
+        } else {
+            tokens.insert(tokens.end(), inicio, inicio + b.longitud_comprimida);
+        }
+    }
+    return true;
+}
+
+void RLECompressor::Calcular_Particion(uint64_t total, int rank, int size, uint64_t& offset, uint64_t& longitud, uint64_t alineacion) {
+    // Se reparten elementos completos; los bytes que no completan uno van al último proceso
+    uint64_t elementos = total / alineacion;
+    uint64_t chunk_base_size = elementos / size;
+    uint64_t remainder = elementos % size;
+
+    longitud = (chunk_base_size + ((uint64_t)rank < remainder ? 1 : 0)) * alineacion;
+    offset = (((uint64_t)rank < remainder)
+             ? ((uint64_t)rank * (chunk_base_size + 1))
+             : ((uint64_t)rank * chunk_base_size + remainder)) * alineacion;
+    if (rank == size - 1) longitud += total - elementos * alineacion;
+}
+
+RLECompressor::Particion RLECompressor::Calcular_Particion_Balanceada(MPI_File fh, uint64_t total, int rank, int size, uint64_t alineacion) {
+    Particion particion;
+    particion.cortes.resize(size + 1);
+    for (int r = 0; r < size; ++r) {
+        uint64_t offset, longitud;
+        Calcular_Particion(total, r, size, offset, longitud, alineacion);
+        particion.cortes[r] = offset;
+    }
+    particion.cortes[size] = total;
+    if (size == 1 || total < (uint64_t)size * TAMANO_MUESTRA) return particion;
+
+    // 1. Costo estimado por región: cada proceso comprime la muestra de las regiones r, r + size, ...
+    uint64_t regiones = min<uint64_t>((uint64_t)size * REGIONES_POR_PROCESO, total / TAMANO_MUESTRA);
+    auto inicio_region = [&](uint64_t i) { return total * i / regiones; };
+
+    vector<double> costos(regiones, 0.0);
+    vector<uint8_t> muestra(TAMANO_MUESTRA), comprimida(MaxCompressedSize(TAMANO_MUESTRA));
+    for (uint64_t i = rank; i < regiones; i += size) {
+        uint64_t longitud_region = inicio_region(i + 1) - inicio_region(i);
+        size_t n = min<uint64_t>(TAMANO_MUESTRA, longitud_region);
+        Leer_MPIIO(fh, inicio_region(i), muestra.data(), n);
+        size_t salida = Comprimir_Local(muestra.data(), n, comprimida.data(), comprimida.size());
+        costos[i] = longitud_region * (n + PESO_SALIDA * salida) / n;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, costos.data(), (int)regiones, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+    vector<double> acumulado(regiones + 1, 0.0);
+    for (uint64_t i = 0; i < regiones; ++i) acumulado[i + 1] = acumulado[i] + costos[i];
+
+    // Costo acumulado hasta un offset (uniforme dentro de cada región) y su inversa
+    auto costo_hasta = [&](uint64_t x) {
+        if (x >= total) return acumulado.back();
+        uint64_t i = (uint64_t)((__uint128_t)x * regiones / total);
+        while (i > 0 && inicio_region(i) > x) i--;
+        while (i + 1 < regiones && inicio_region(i + 1) <= x) i++;
+        double fraccion = (double)(x - inicio_region(i)) / (inicio_region(i + 1) - inicio_region(i));
+        return acumulado[i] + fraccion * costos[i];
+    };
+    auto offset_de_costo = [&](double objetivo) {
+        uint64_t i = upper_bound(acumulado.begin() + 1, acumulado.end(), objetivo) - (acumulado.begin() + 1);
+        if (i >= regiones) return total;
+        double fraccion = costos[i] > 0 ? (objetivo - acumulado[i]) / costos[i] : 0.0;
+        return inicio_region(i) + (uint64_t)(fraccion * (inicio_region(i + 1) - inicio_region(i)));
+    };
+    auto desbalance = [&](const vector<uint64_t>& cortes) {
+        double maximo = 0.0;
+        for (int r = 0; r < size; ++r) maximo = max(maximo, costo_hasta(cortes[r + 1]) - costo_hasta(cortes[r]));
+        return acumulado.back() > 0 ? maximo / (acumulado.back() / size) : 1.0;
+    };
+    particion.desbalance_uniforme = desbalance(particion.cortes);
+
+    vector<uint64_t> cortes(size + 1, total);
+    for (int r = 0; r < size; ++r) cortes[r] = offset_de_costo(acumulado.back() * r / size);
+    cortes[0] = 0;
+
+    // 2. Cada proceso adelanta su corte inicial al siguiente cambio de valor (sin pasar el corte siguiente)
+    uint64_t inicio = cortes[rank];
+    if (rank > 0 && inicio > 0 && inicio < cortes[rank + 1]) {
+        size_t n = min<uint64_t>(ALINEACION_CORTE + 1, cortes[rank + 1] - inicio + 1);
+        vector<uint8_t> ventana(n);
+        Leer_MPIIO(fh, inicio - 1, ventana.data(), n);
+        for (size_t p = 1; p < n; ++p) {
+            if (ventana[p] != ventana[p - 1]) {
+                inicio = inicio - 1 + p;
+                break;
+            }
+        }
+    }
+    // Con elementos, el corte retrocede a la frontera de elemento (la corrida cruza a lo más un elemento)
+    if (inicio < total) inicio -= inicio % alineacion;
+    MPI_Allgather(&inicio, 1, MPI_UINT64_T, cortes.data(), 1, MPI_UINT64_T, MPI_COMM_WORLD);
+    cortes[size] = total;
+    for (int r = 1; r <= size; ++r) cortes[r] = max(cortes[r], cortes[r - 1]);
+
+    particion.cortes = cortes;
+    particion.desbalance_balanceado = desbalance(cortes);
+    return particion;
+}
+
+void RLECompressor::Leer_MPIIO(MPI_File fh, MPI_Offset offset, uint8_t* datos, size_t longitud, size_t trozo) {
+    while (longitud > 0) {
+        size_t n = min(longitud, trozo);
+        MPI_File_read_at(fh, offset, datos, (int)n, MPI_UNSIGNED_CHAR, MPI_STATUS_IGNORE);
+        offset += n;
+        datos += n;
+        longitud -= n;
+    }
+}
+
+// Segmento de memoria a escribir (puntero, longitud)
+typedef pair<const uint8_t*, size_t> Segmento;
+
+// Tramo contiguo del archivo que empieza en `offset`, formado por segmentos de memoria.
+struct Tramo {
+    MPI_Offset offset;
+    vector<Segmento> segmentos;
+};
+
+// Escribe colectivamente una lista de tramos. Los segmentos de cada tramo se agrupan en lotes de a lo
+// más `trozo` bytes descritos por un tipo derivado (hindexed), sin copiarlos a un buffer intermedio.
+// Todos los procesos ejecutan el mismo número de llamadas a MPI_File_write_at_all (vacías cuando ya
+// no les quedan lotes).
+static void Escribir_Tramos_Colectivo(MPI_File fh, const vector<Tramo>& tramos, size_t trozo) {
+    vector<Tramo> lotes;
+    for (const Tramo& tramo : tramos) {
+        lotes.push_back(Tramo{tramo.offset, {}});
+        size_t acumulado = 0;
+        for (Segmento segmento : tramo.segmentos) {
+            while (segmento.second > 0) {
+                size_t n = min(segmento.second, trozo - acumulado);
+                lotes.back().segmentos.push_back(Segmento(segmento.first, n));
+                segmento.first += n;
+                segmento.second -= n;
+                acumulado += n;
+                if (acumulado == trozo) {
+                    lotes.push_back(Tramo{lotes.back().offset + (MPI_Offset)trozo, {}});
+                    acumulado = 0;
+                }
+            }
+        }
+        if (lotes.back().segmentos.empty()) lotes.pop_back();
+    }
+
+    int mis_lotes = lotes.size();
+    int max_lotes = 0;
+    MPI_Allreduce(&mis_lotes, &max_lotes, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+    for (int l = 0; l < max_lotes; ++l) {
+        if (l >= mis_lotes) {
+            MPI_File_write_at_all(fh, 0, nullptr, 0, MPI_BYTE, MPI_STATUS_IGNORE);
+            continue;
+        }
+
+        vector<MPI_Aint> desplazamientos;
+        vector<int> longitudes;
+        for (const Segmento& segmento : lotes[l].segmentos) {
+            MPI_Aint direccion;
+            MPI_Get_address(segmento.first, &direccion);
+            desplazamientos.push_back(direccion);
+            longitudes.push_back((int)segmento.second);
+        }
+
+        MPI_Datatype tipo_lote;
+        MPI_Type_create_hindexed(longitudes.size(), longitudes.data(), desplazamientos.data(), MPI_BYTE, &tipo_lote);
+        MPI_Type_commit(&tipo_lote);
+        MPI_File_write_at_all(fh, lotes[l].offset, MPI_BOTTOM, 1, tipo_lote, MPI_STATUS_IGNORE);
+        MPI_Type_free(&tipo_lote);
+    }
+}
+
+// Escribe colectivamente los segmentos como un único tramo que empieza en `offset`.
+static void Escribir_Segmentos_Colectivo(MPI_File fh, MPI_Offset offset, const vector<Segmento>& segmentos, size_t trozo) {
+    Escribir_Tramos_Colectivo(fh, {Tramo{offset, segmentos}}, trozo);
+}
+
+void RLECompressor::Escribir_MPIIO_Colectivo(MPI_File fh, MPI_Offset offset, const uint8_t* datos, size_t longitud, size_t trozo) {
+    Escribir_Segmentos_Colectivo(fh, offset, {Segmento(datos, longitud)}, trozo);
+}
+
+vector<uint64_t> RLECompressor::Recolectar_En_Rank0(const uint8_t* local, uint64_t longitud, vector<uint8_t>& global, int rank, int size, size_t trozo) {
+    vector<uint64_t> global_lengths(size);
+    MPI_Gather(&longitud, 1, MPI_UINT64_T, global_lengths.data(), 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+    uint64_t total = 0;
+    if (rank == 0) {
+        for (uint64_t l : global_lengths) total += l;
+        global.resize(total);
+    }
+    MPI_Bcast(&total, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+    if (total <= trozo) {
+        vector<int> counts(size), displacements(size, 0);
+        if (rank == 0) {
+            for (int i = 0; i < size; ++i) {
+                counts[i] = (int)global_lengths[i];
+                displacements[i] = (i > 0) ? (displacements[i-1] + counts[i-1]) : 0;
+            }
+        }
+        MPI_Gatherv(local, (int)longitud, MPI_UNSIGNED_CHAR,
+                    global.data(), counts.data(), displacements.data(),
+                    MPI_UNSIGNED_CHAR, 0, MPI_COMM_WORLD);
+        return global_lengths;
+    }
+
+    // Más de lo que admite un conteo int: mensajes punto a punto en trozos
+    if (rank == 0) {
+        uint8_t* destino = global.data();
+        if (longitud > 0) memcpy(destino, local, longitud);
+        destino += longitud;
+        for (int r = 1; r < size; ++r) {
+            for (uint64_t recibido = 0; recibido < global_lengths[r]; ) {
+                size_t n = min<uint64_t>(global_lengths[r] - recibido, trozo);
+                MPI_Recv(destino, (int)n, MPI_UNSIGNED_CHAR, r, RECOLECCION_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                destino += n;
+                recibido += n;
+            }
+        }
+    } else {
+        for (uint64_t enviado = 0; enviado < longitud; ) {
+            size_t n = min<uint64_t>(longitud - enviado, trozo);
+            MPI_Send(local + enviado, (int)n, MPI_UNSIGNED_CHAR, 0, RECOLECCION_TAG, MPI_COMM_WORLD);
+            enviado += n;
+        }
+    }
+    return global_lengths;
+}
 
 void RLECompressor::Leer_Bloque_MPIIO(
     const std::string& input_file, 
@@ -99,400 +1028,1722 @@ void RLECompressor::Leer_Bloque_MPIIO(
     int size, 
     std::vector<uint8_t>& buffer_in, 
     size_t& global_file_size,
-    size_t& offset_start
+    size_t& offset_start,
+    size_t alineacion
 ) {
     MPI_File fh;
     int error;
 
     error = MPI_File_open(MPI_COMM_WORLD, input_file.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
     if (error != MPI_SUCCESS) {
-        std::cerr << "P" << rank << ": Error al abrir el archivo: " << input_file << std::endl;
+        std::cerr << "P" << rank << ": Error al abrir el archivo: " << input_file << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    MPI_Offset file_size_mpi;
+    
+    MPI_File_get_size(fh, &file_size_mpi);
+    global_file_size = (size_t)file_size_mpi;
+
+    uint64_t my_offset = 0, my_chunk_size = 0;
+    Calcular_Particion(global_file_size, rank, size, my_offset, my_chunk_size, alineacion);
+    offset_start = my_offset;
+
+    // Se lee el primer elemento del tramo siguiente (un byte si no hay elementos)
+    size_t extra_byte_to_read = (rank < size - 1) ? alineacion : 0;
+    size_t read_size = my_chunk_size + extra_byte_to_read;
+    
+    buffer_in.resize(read_size);
+    
+    Leer_MPIIO(fh, offset_start, buffer_in.data(), read_size);
+    
+    MPI_File_close(&fh);
+}
+
+// Bytes que ocupa la codificación de una corrida de `n` bytes iguales a `valor`: tuplas de 255 y el
+// resto como tupla (3 o más) o como literales (escapados si son banderas). Con conteos LEB128 la
+// corrida es una sola tupla.
+static size_t Tamano_Corrida(uint8_t valor, uint64_t n, uint8_t codec) {
+    size_t literal = (valor == FLAG_RLE || valor == FLAG_LITERAL) ? 2 : 1;
+    if (codec == RLEContainer::CODEC_RLE_VARINT) {
+        return (n >= RLE_THRESHOLD) ? 2 + Longitud_Varint(n) : n * literal;
+    }
+    uint64_t resto = n % 255;
+    return 3 * (n / 255) + (resto >= RLE_THRESHOLD ? 3 : resto * literal);
+}
+
+// Resumen de las fronteras de un tramo (o de varios tramos consecutivos) para el prefijo paralelo.
+// Un tramo es uniforme si inicial == longitud.
+struct ResumenTramo {
+    uint64_t longitud = 0;
+    uint64_t inicial = 0;  // Longitud de la corrida inicial
+    uint64_t final = 0;    // Longitud de la corrida final
+    uint64_t primero = 0;
+    uint64_t ultimo = 0;
+};
+
+// Resumen de la concatenación de `a` seguido de `b`. Es asociativa, con el tramo vacío como neutro.
+static ResumenTramo Combinar_Resumenes(const ResumenTramo& a, const ResumenTramo& b) {
+    if (a.longitud == 0) return b;
+    if (b.longitud == 0) return a;
+
+    bool unidos = a.ultimo == b.primero;
+    ResumenTramo r;
+    r.longitud = a.longitud + b.longitud;
+    r.primero = a.primero;
+    r.ultimo = b.ultimo;
+    r.inicial = (a.inicial == a.longitud && unidos) ? a.longitud + b.inicial : a.inicial;
+    r.final = (b.final == b.longitud && unidos) ? b.longitud + a.final : b.final;
+    return r;
+}
+
+// Operaciones MPI (no conmutativas): `entrada` viene de los ranks menores del comunicador. En el
+// comunicador invertido esos ranks son los posteriores en el archivo.
+static void Op_Resumen_Prefijo(void* entrada, void* entrada_salida, int* n, MPI_Datatype*) {
+    ResumenTramo* a = (ResumenTramo*)entrada;
+    ResumenTramo* b = (ResumenTramo*)entrada_salida;
+    for (int i = 0; i < *n; ++i) b[i] = Combinar_Resumenes(a[i], b[i]);
+}
+
+static void Op_Resumen_Sufijo(void* entrada, void* entrada_salida, int* n, MPI_Datatype*) {
+    ResumenTramo* a = (ResumenTramo*)entrada;
+    ResumenTramo* b = (ResumenTramo*)entrada_salida;
+    for (int i = 0; i < *n; ++i) b[i] = Combinar_Resumenes(b[i], a[i]);
+}
+
+// Resumen de las fronteras acumuladas durante la compresión de un tramo.
+static ResumenTramo Resumen_De_Frontera(const RLECompressor::Frontera& frontera) {
+    ResumenTramo r;
+    r.longitud = frontera.longitud;
+    r.inicial = frontera.corrida_inicial;
+    r.final = frontera.corrida_final;
+    r.primero = frontera.primer_byte;
+    r.ultimo = frontera.ultimo_byte;
+    return r;
+}
+
+// Resumen anticipado de un tramo a partir de muestras de TAMANO_MUESTRA bytes de su inicio y su
+// final, antes de comprimirlo. Retorna false si no es exacto: la corrida inicial o la final ocupan
+// toda su muestra y podrían continuar dentro del tramo.
+static bool Resumir_Tramo_Anticipado(MPI_File fh, uint64_t offset, uint64_t longitud, ResumenTramo& r) {
+    r = ResumenTramo();
+    r.longitud = longitud;
+    if (longitud == 0) return true;
+
+    size_t n = min<uint64_t>(longitud, RLECompressor::TAMANO_MUESTRA);
+    vector<uint8_t> inicio(n);
+    MPI_File_read_at(fh, offset, inicio.data(), (int)n, MPI_UNSIGNED_CHAR, MPI_STATUS_IGNORE);
+    r.primero = inicio[0];
+    r.inicial = RLEKernels::Longitud_Corrida(inicio.data(), n, inicio[0]);
+    if (r.inicial == n && n < longitud) return false;
+
+    vector<uint8_t> fin;
+    if (n < longitud) {
+        fin.resize(n);
+        MPI_File_read_at(fh, offset + longitud - n, fin.data(), (int)n, MPI_UNSIGNED_CHAR, MPI_STATUS_IGNORE);
+    } else {
+        fin.swap(inicio);
+    }
+    r.ultimo = fin[n - 1];
+    while (r.final < n && fin[n - 1 - r.final] == fin[n - 1]) r.final++;
+    return r.final < n || n == longitud;
+}
+
+// Intercambio no bloqueante de los resúmenes de frontera. Los búferes y peticiones deben seguir
+// vivos hasta Completar_Fronteras.
+struct IntercambioFronteras {
+    ResumenTramo propio, previo, posterior;
+    MPI_Comm inverso = MPI_COMM_NULL;
+    MPI_Datatype tipo = MPI_DATATYPE_NULL;
+    MPI_Op op_prefijo = MPI_OP_NULL, op_sufijo = MPI_OP_NULL;
+    MPI_Request peticiones[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+    bool iniciado = false;
+};
+
+// Crea el comunicador en orden inverso, el tipo y las operaciones. Es colectiva y bloqueante, así que
+// todos los procesos la llaman antes de comprimir; Iniciar_Fronteras puede llamarse después en
+// momentos distintos en cada proceso.
+static void Preparar_Fronteras(IntercambioFronteras& intercambio, int rank, int size) {
+    if (size == 1) return;
+    MPI_Type_contiguous(5, MPI_UINT64_T, &intercambio.tipo);
+    MPI_Type_commit(&intercambio.tipo);
+    MPI_Op_create(&Op_Resumen_Prefijo, 0, &intercambio.op_prefijo);
+    MPI_Op_create(&Op_Resumen_Sufijo, 0, &intercambio.op_sufijo);
+    MPI_Comm_split(MPI_COMM_WORLD, 0, size - 1 - rank, &intercambio.inverso);
+}
+
+// Publica el resumen del tramo propio: prefijo exclusivo de los tramos anteriores y, sobre el
+// comunicador en orden inverso, de los posteriores, cada uno en O(log P) pasos sin importar cuántos
+// procesos cruce una corrida.
+static void Iniciar_Fronteras(IntercambioFronteras& intercambio, const ResumenTramo& propio) {
+    if (intercambio.inverso == MPI_COMM_NULL) return;
+    intercambio.propio = propio;
+    MPI_Iexscan(&intercambio.propio, &intercambio.previo, 1, intercambio.tipo, intercambio.op_prefijo, MPI_COMM_WORLD, &intercambio.peticiones[0]);
+    MPI_Iexscan(&intercambio.propio, &intercambio.posterior, 1, intercambio.tipo, intercambio.op_sufijo, intercambio.inverso, &intercambio.peticiones[1]);
+    intercambio.iniciado = true;
+}
+
+// Avanza el intercambio pendiente (sin hilo de progreso, MPI solo avanza dentro de llamadas MPI).
+static void Progresar_Fronteras(IntercambioFronteras& intercambio) {
+    if (!intercambio.iniciado) return;
+    int listo = 0;
+    MPI_Testall(2, intercambio.peticiones, &listo, MPI_STATUSES_IGNORE);
+}
+
+// Espera el intercambio y aplica la corrección a la salida local. Cada corrida que cruza procesos la
+// emite completa el proceso donde empieza. La salida local es la codificación canónica del tramo, así
+// que la corrida inicial ocupa exactamente sus primeros Tamano_Corrida bytes y la final sus últimos.
+// Ajusta `crc` (el CRC32C del tramo) a los bytes que quedan a cargo de este proceso: sin la corrida
+// inicial cedida al anterior y con la continuación absorbida del posterior.
+// Retorna el offset en `local_output` donde empieza la salida válida de este proceso.
+static size_t Completar_Fronteras(vector<uint8_t>& local_output, IntercambioFronteras& intercambio, int rank, int size, uint8_t codec, uint32_t& crc) {
+    if (intercambio.inverso == MPI_COMM_NULL) return 0;
+    MPI_Waitall(2, intercambio.peticiones, MPI_STATUSES_IGNORE);
+    if (rank == 0) intercambio.previo = ResumenTramo();
+    if (rank == size - 1) intercambio.posterior = ResumenTramo();
+
+    MPI_Comm_free(&intercambio.inverso);
+    MPI_Op_free(&intercambio.op_prefijo);
+    MPI_Op_free(&intercambio.op_sufijo);
+    MPI_Type_free(&intercambio.tipo);
+
+    const ResumenTramo& propio = intercambio.propio;
+    const ResumenTramo& previo = intercambio.previo;
+    const ResumenTramo& posterior = intercambio.posterior;
+    if (propio.longitud == 0) return 0;
+
+    bool uniforme = propio.inicial == propio.longitud;
+    bool continua = previo.longitud > 0 && previo.ultimo == propio.primero;
+    bool sigue = posterior.longitud > 0 && posterior.primero == propio.ultimo;
+
+    size_t inicio = 0;
+    if (continua) {
+        if (uniforme) {
+            crc = 0;
+            return local_output.size();
+        }
+        inicio = Tamano_Corrida(propio.primero, propio.inicial, codec);
+        // CRC(B) = CRC(A || B) ^ CRC(A) desplazado |B| bytes
+        uint8_t primero = (uint8_t)propio.primero;
+        uint32_t crc_corrida = Extender_CRC_Repetido(0, &primero, 1, propio.inicial);
+        crc ^= RLEKernels::CRC32C_Combinar(crc_corrida, 0, propio.longitud - propio.inicial);
+    }
+    if (sigue) {
+        uint8_t ultimo = (uint8_t)propio.ultimo;
+        crc = RLEKernels::CRC32C_Combinar(crc, Extender_CRC_Repetido(0, &ultimo, 1, posterior.inicial), posterior.inicial);
+        local_output.resize(local_output.size() - Tamano_Corrida(propio.ultimo, propio.final, codec));
+        RLECompressor::Corrida corrida;
+        corrida.codec = codec;
+        RLECompressor::Agregar_Corrida(corrida, (uint8_t)propio.ultimo, propio.final + posterior.inicial, local_output);
+        RLECompressor::Cerrar_Corrida(corrida, local_output);
+    }
+    return inicio;
+}
+
+size_t RLECompressor::Corregir_Fronteras(std::vector<uint8_t>& local_output, const Frontera& frontera, int rank, int size, uint8_t codec) {
+    IntercambioFronteras intercambio;
+    if (Literales_En_Bloques(codec)) return 0;
+    Preparar_Fronteras(intercambio, rank, size);
+    Iniciar_Fronteras(intercambio, Resumen_De_Frontera(frontera));
+    uint32_t crc = frontera.crc;
+    return Completar_Fronteras(local_output, intercambio, rank, size, codec, crc);
+}
+
+// --- Funciones auxiliares del contenedor por bloques ---
+
+// Recolecta en el rank 0 los descriptores de bloque (longitud comprimida, original, tipo y checksum) de todos los procesos.
+static vector<RLEContainer::Bloque> Recolectar_Bloques(const vector<RLEContainer::Bloque>& bloques_locales, int rank, int size) {
+    const int CAMPOS = 4;
+    int local_num_bloques = bloques_locales.size();
+    vector<uint64_t> local_desc(CAMPOS * local_num_bloques);
+    for (int i = 0; i < local_num_bloques; ++i) {
+        local_desc[CAMPOS * i] = bloques_locales[i].longitud_comprimida;
+        local_desc[CAMPOS * i + 1] = bloques_locales[i].longitud_original;
+        local_desc[CAMPOS * i + 2] = bloques_locales[i].tipo;
+        local_desc[CAMPOS * i + 3] = bloques_locales[i].checksum;
+    }
+
+    vector<int> global_num_bloques(size);
+    MPI_Gather(&local_num_bloques, 1, MPI_INT, global_num_bloques.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    vector<int> desc_counts(size, 0);
+    vector<int> desc_displacements(size, 0);
+    vector<uint64_t> global_desc;
+
+    if (rank == 0) {
+        for (int i = 0; i < size; ++i) {
+            desc_counts[i] = CAMPOS * global_num_bloques[i];
+            desc_displacements[i] = (i > 0) ? (desc_displacements[i-1] + desc_counts[i-1]) : 0;
+        }
+        global_desc.resize(desc_displacements[size - 1] + desc_counts[size - 1]);
+    }
+
+    MPI_Gatherv(
+        local_desc.data(), CAMPOS * local_num_bloques, MPI_UINT64_T,
+        global_desc.data(), desc_counts.data(), desc_displacements.data(),
+        MPI_UINT64_T, 0, MPI_COMM_WORLD
+    );
+
+    vector<RLEContainer::Bloque> bloques(global_desc.size() / CAMPOS);
+    for (size_t i = 0; i < bloques.size(); ++i) {
+        bloques[i].longitud_comprimida = global_desc[CAMPOS * i];
+        bloques[i].longitud_original = global_desc[CAMPOS * i + 1];
+        bloques[i].tipo = (uint8_t)global_desc[CAMPOS * i + 2];
+        bloques[i].checksum = (uint32_t)global_desc[CAMPOS * i + 3];
+    }
+    return bloques;
+}
+
+// Tamaño en disco de un contenedor con `num_bloques` bloques y `carga` bytes de carga total.
+static size_t Tamano_Contenedor(size_t num_bloques, size_t carga) {
+    return RLEContainer::TAMANO_CABECERA + carga
+         + num_bloques * (RLEContainer::TAMANO_REGISTRO + RLEContainer::TAMANO_ENTRADA_INDICE)
+         + RLEContainer::TAMANO_REGISTRO + RLEContainer::TAMANO_PIE;
+}
+
+// El rank 0 lee la cabecera, el pie y el índice, y los difunde al resto de procesos.
+// Retorna false si el archivo no es un contenedor (formato heredado sin cabecera).
+static bool Leer_Indice_MPIIO(MPI_File fh, MPI_Offset file_size, int rank, RLEContainer::Cabecera& cabecera, vector<RLEContainer::Bloque>& bloques) {
+    int es_contenedor = 0;
+    vector<uint64_t> paquete;
+
+    if (rank == 0 && (size_t)file_size >= RLEContainer::TAMANO_CABECERA + RLEContainer::TAMANO_REGISTRO + RLEContainer::TAMANO_PIE) {
+        uint8_t buffer_cabecera[RLEContainer::TAMANO_CABECERA];
+        uint8_t buffer_pie[RLEContainer::TAMANO_PIE];
+        MPI_File_read_at(fh, 0, buffer_cabecera, RLEContainer::TAMANO_CABECERA, MPI_UNSIGNED_CHAR, MPI_STATUS_IGNORE);
+        MPI_File_read_at(fh, file_size - RLEContainer::TAMANO_PIE, buffer_pie, RLEContainer::TAMANO_PIE, MPI_UNSIGNED_CHAR, MPI_STATUS_IGNORE);
+
+        uint64_t offset_indice = 0, num_bloques = 0;
+        if (RLEContainer::Parsear_Cabecera(buffer_cabecera, cabecera) &&
+            RLEContainer::Parsear_Pie(buffer_pie, file_size, offset_indice, num_bloques)) {
+
+            vector<uint8_t> indice(num_bloques * RLEContainer::TAMANO_ENTRADA_INDICE);
+            if (!indice.empty()) {
+                RLECompressor::Leer_MPIIO(fh, offset_indice, indice.data(), indice.size());
+            }
+            es_contenedor = RLEContainer::Parsear_Indice(indice.data(), num_bloques, offset_indice, bloques) ? 1 : 0;
+        }
+
+        if (es_contenedor) {
+            paquete = {cabecera.version, cabecera.codec, cabecera.banderas, cabecera.tamano_original};
+            for (const RLEContainer::Bloque& b : bloques) {
+                paquete.push_back(b.offset);
+                paquete.push_back(b.longitud_comprimida);
+                paquete.push_back(b.longitud_original);
+            }
+        }
+    }
+
+    MPI_Bcast(&es_contenedor, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!es_contenedor) return false;
+
+    uint64_t paquete_len = paquete.size();
+    MPI_Bcast(&paquete_len, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    paquete.resize(paquete_len);
+    // Índices con muchos bloques pueden exceder un conteo int: se difunden en trozos
+    const uint64_t TROZO_PAQUETE = RLECompressor::TROZO_MAX_IO / sizeof(uint64_t);
+    for (uint64_t enviado = 0; enviado < paquete_len; enviado += TROZO_PAQUETE) {
+        int n = (int)min(paquete_len - enviado, TROZO_PAQUETE);
+        MPI_Bcast(paquete.data() + enviado, n, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    }
+
+    cabecera.version = (uint8_t)paquete[0];
+    cabecera.codec = (uint8_t)paquete[1];
+    cabecera.banderas = (uint16_t)paquete[2];
+    cabecera.tamano_original = paquete[3];
+
+    bloques.resize((paquete_len - 4) / 3);
+    for (size_t i = 0; i < bloques.size(); ++i) {
+        bloques[i].offset = paquete[4 + 3 * i];
+        bloques[i].longitud_comprimida = paquete[5 + 3 * i];
+        bloques[i].longitud_original = paquete[6 + 3 * i];
+    }
+    return true;
+}
+
+// Abre (o crea) el archivo de salida para la escritura colectiva y fija su tamaño final.
+static MPI_File Abrir_Salida_MPIIO(const string& output_file, MPI_Offset tamano_final, int rank) {
+    MPI_File fh;
+    int error = MPI_File_open(MPI_COMM_WORLD, output_file.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+    if (error != MPI_SUCCESS) {
+        if (rank == 0) cerr << "P" << rank << ": ERROR al abrir el archivo de salida para escritura: " << output_file << endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    // Evita que queden restos de un archivo previo más largo
+    MPI_File_set_size(fh, tamano_final);
+    return fh;
+}
+
+// Escritura colectiva del contenedor: cada proceso obtiene su offset con un prefijo exclusivo de sus
+// bytes locales y escribe sus registros y cargas con MPI_File_write_at_all; después escribe su tramo
+// del índice. El rank 0 añade la cabecera y el último rank el registro FIN y el pie.
+// Retorna el tamaño total del archivo.
+static size_t Escribir_Contenedor_Colectivo(const string& output_file, const RLEContainer::Cabecera& cabecera, const uint8_t* carga, vector<RLEContainer::Bloque>& bloques_locales, int rank, int size) {
+    // [0]: bytes de registros + cargas, [1]: número de bloques
+    uint64_t local[2] = {0, bloques_locales.size()};
+    for (const RLEContainer::Bloque& b : bloques_locales) {
+        local[0] += RLEContainer::TAMANO_REGISTRO + b.longitud_comprimida;
+    }
+
+    uint64_t previo[2] = {0, 0};
+    uint64_t total[2] = {0, 0};
+    MPI_Exscan(local, previo, 2, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    if (rank == 0) previo[0] = previo[1] = 0;
+    MPI_Allreduce(local, total, 2, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+
+    uint64_t offset_datos = RLEContainer::TAMANO_CABECERA + previo[0];
+    uint64_t offset_indice = RLEContainer::TAMANO_CABECERA + total[0] + RLEContainer::TAMANO_REGISTRO;
+    uint64_t tamano_total = offset_indice + total[1] * RLEContainer::TAMANO_ENTRADA_INDICE + RLEContainer::TAMANO_PIE;
+    RLEContainer::Asignar_Offsets(bloques_locales, offset_datos);
+
+    // Segmentos de la memoria local: se escriben registros y cargas sin copiarlos a un buffer intermedio
+    uint8_t buffer_cabecera[RLEContainer::TAMANO_CABECERA];
+    vector<uint8_t> registros((bloques_locales.size() + 1) * RLEContainer::TAMANO_REGISTRO);
+    vector<Segmento> segmentos;
+
+    MPI_Offset offset_escritura = offset_datos;
+    if (rank == 0) {
+        RLEContainer::Serializar_Cabecera(cabecera, buffer_cabecera);
+        segmentos.push_back(Segmento(buffer_cabecera, RLEContainer::TAMANO_CABECERA));
+        offset_escritura = 0;
+    }
+    for (size_t i = 0; i < bloques_locales.size(); ++i) {
+        uint8_t* registro = registros.data() + i * RLEContainer::TAMANO_REGISTRO;
+        RLEContainer::Serializar_Registro(bloques_locales[i], registro);
+        segmentos.push_back(Segmento(registro, RLEContainer::TAMANO_REGISTRO));
+        segmentos.push_back(Segmento(carga, bloques_locales[i].longitud_comprimida));
+        carga += bloques_locales[i].longitud_comprimida;
+    }
+    if (rank == size - 1) {
+        RLEContainer::Bloque fin;
+        fin.tipo = RLEContainer::BLOQUE_FIN;
+        uint8_t* registro = registros.data() + bloques_locales.size() * RLEContainer::TAMANO_REGISTRO;
+        RLEContainer::Serializar_Registro(fin, registro);
+        segmentos.push_back(Segmento(registro, RLEContainer::TAMANO_REGISTRO));
+    }
+
+    MPI_File fh = Abrir_Salida_MPIIO(output_file, tamano_total, rank);
+    Escribir_Segmentos_Colectivo(fh, offset_escritura, segmentos, RLECompressor::TROZO_MAX_IO);
+
+    vector<uint8_t> entradas = RLEContainer::Serializar_Entradas(bloques_locales);
+    if (rank == size - 1) {
+        entradas.resize(entradas.size() + RLEContainer::TAMANO_PIE);
+        RLEContainer::Serializar_Pie(offset_indice, total[1], entradas.data() + entradas.size() - RLEContainer::TAMANO_PIE);
+    }
+    RLECompressor::Escribir_MPIIO_Colectivo(fh, offset_indice + previo[1] * RLEContainer::TAMANO_ENTRADA_INDICE, entradas.data(), entradas.size());
+    MPI_File_close(&fh);
+
+    return tamano_total;
+}
+
+// Ruta de comparación: el rank 0 recolecta cargas y descriptores con MPI_Gatherv y escribe el contenedor.
+// Retorna el tamaño total del archivo (solo en el rank 0).
+static size_t Escribir_Contenedor_Gather(const string& output_file, const RLEContainer::Cabecera& cabecera, const uint8_t* carga, size_t longitud_carga, const vector<RLEContainer::Bloque>& bloques_locales, int rank, int size) {
+    vector<RLEContainer::Bloque> bloques = Recolectar_Bloques(bloques_locales, rank, size);
+
+    vector<uint8_t> global_compressed_output;
+    RLECompressor::Recolectar_En_Rank0(carga, longitud_carga, global_compressed_output, rank, size);
+    size_t total_compressed_size = global_compressed_output.size();
+
+    if (rank == 0) {
+        ofstream ofs(output_file, ios::binary);
+        if (ofs.is_open()) {
+            RLEContainer::Escribir(ofs, cabecera, global_compressed_output.data(), bloques);
+            ofs.close();
+        } else {
+            cerr << "P0: ERROR al abrir el archivo de salida para escritura: " << output_file << endl;
+        }
+    }
+    return Tamano_Contenedor(bloques.size(), total_compressed_size);
+}
+
+// Escritura colectiva de la salida descomprimida: cada proceso escribe su tramo en su offset de salida.
+static void Escribir_Salida_Colectiva(const string& output_file, const vector<uint8_t>& local_output, uint64_t output_offset, uint64_t total_size, int rank) {
+    MPI_File fh = Abrir_Salida_MPIIO(output_file, total_size, rank);
+    RLECompressor::Escribir_MPIIO_Colectivo(fh, output_offset, local_output.data(), local_output.size());
+    MPI_File_close(&fh);
+}
+
+// Ruta de comparación: el rank 0 recolecta la salida descomprimida con MPI_Gatherv y la escribe.
+static void Escribir_Salida_Gather(const string& output_file, const vector<uint8_t>& local_decompressed_output, int rank, int size) {
+    std::vector<uint8_t> global_decompressed_output;
+    RLECompressor::Recolectar_En_Rank0(local_decompressed_output.data(), local_decompressed_output.size(), global_decompressed_output, rank, size);
+    size_t total_decompressed_size = global_decompressed_output.size();
+
+    if (rank == 0) {
+        std::ofstream ofs(output_file, std::ios::binary);
+        if (ofs.is_open()) {
+            ofs.write((const char*)global_decompressed_output.data(), total_decompressed_size);
+            ofs.close();
+        } else {
+            std::cerr << "P0: ERROR al abrir el archivo de salida para escritura: " << output_file << std::endl;
+        }
+    }
+}
+
+// Descompresión paralela de un contenedor: cada proceso recibe un rango contiguo de bloques
+// equilibrado por bytes descomprimidos, lee exactamente sus bloques y conoce su offset de salida.
+// Con `verificar` cada bloque se comprueba contra el CRC32C de su registro.
+static vector<uint8_t> Descomprimir_Contenedor_Paralelo(MPI_File fh, const vector<RLEContainer::Bloque>& bloques, uint8_t codec, bool verificar, PoolHilos& pool, Metricas& metricas, int rank, int size, size_t& output_offset) {
+    vector<uint64_t> prefijo(bloques.size() + 1, 0);
+    for (size_t i = 0; i < bloques.size(); ++i) {
+        prefijo[i + 1] = prefijo[i] + bloques[i].longitud_original;
+    }
+    uint64_t total = prefijo.back();
+
+    // Propietario de cada bloque según el punto medio de su rango descomprimido
+    size_t lo = bloques.size(), hi = bloques.size();
+    for (size_t i = 0; i < bloques.size(); ++i) {
+        double medio = prefijo[i] + bloques[i].longitud_original / 2.0;
+        int propietario = (total > 0) ? (int)(medio / total * size) : 0;
+        propietario = min(propietario, size - 1);
+
+        if (propietario == rank && lo == bloques.size()) lo = i;
+        if (propietario > rank) {
+            hi = i;
+            break;
+        }
+    }
+    if (lo > hi) lo = hi;
+
+    output_offset = prefijo[lo];
+    vector<uint8_t> salida;
+    if (lo == hi) return salida;
+
+    MPI_Offset read_offset = bloques[lo].offset;
+    size_t read_size = bloques[hi - 1].offset + RLEContainer::TAMANO_REGISTRO + bloques[hi - 1].longitud_comprimida - read_offset;
+
+    Timer t_lectura;
+    vector<uint8_t> compressed_buffer_in(read_size);
+    RLECompressor::Leer_MPIIO(fh, read_offset, compressed_buffer_in.data(), read_size);
+    metricas.Registrar(Fase::Lectura, t_lectura.stop(), read_size);
+
+    // Cada bloque se descomprime directamente en su posición de la salida local; los bloques son
+    // independientes y se reparten entre los hilos, y los errores se reportan desde este hilo
+    Timer t_codificacion;
+    salida.resize(prefijo[hi] - prefijo[lo]);
+    vector<uint8_t> correcto(hi - lo, 0);
+    pool.Ejecutar(hi - lo, [&](size_t k) {
+        size_t i = lo + k;
+        const uint8_t* registro = compressed_buffer_in.data() + (bloques[i].offset - read_offset);
+        RLEContainer::Bloque leido = RLEContainer::Parsear_Registro(registro);
+        if (leido.longitud_comprimida != bloques[i].longitud_comprimida || leido.longitud_original != bloques[i].longitud_original) return;
+
+        correcto[k] = RLECompressor::Descomprimir_Bloque(leido, registro + RLEContainer::TAMANO_REGISTRO, salida.data() + (prefijo[i] - prefijo[lo]), codec, verificar);
+    });
+    metricas.Registrar(Fase::Codificacion, t_codificacion.stop(), salida.size());
+
+    for (size_t i = lo; i < hi; ++i) {
+        if (!correcto[i - lo]) {
+            cerr << "P" << rank << ": Bloque " << i << " corrupto en el archivo comprimido." << endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    return salida;
+}
+
+// Descompresión paralela del formato heredado (flujo RLE sin cabecera): cada proceso toma un rango
+// de bytes igual y usa un solapamiento fijo para alinear los tokens cortados en la frontera.
+static vector<uint8_t> Descomprimir_Heredado_Paralelo(MPI_File fh, size_t compressed_file_size, Metricas& metricas, int rank, int size) {
+    uint64_t offset_start = 0, my_chunk_size = 0;
+    RLECompressor::Calcular_Particion(compressed_file_size, rank, size, offset_start, my_chunk_size);
+
+    const size_t OVERLAP_BYTES = 2;
+    size_t overlap_read = 0;
+    MPI_Offset read_offset = offset_start;
+
+    if (rank > 0) {
+        if (offset_start >= OVERLAP_BYTES) {
+            read_offset -= OVERLAP_BYTES;
+            overlap_read = OVERLAP_BYTES;
+        } else {
+            read_offset = 0;
+            overlap_read = offset_start;
+        }
+    }
+
+    size_t read_size = my_chunk_size + overlap_read;
+
+    Timer t_lectura;
+    std::vector<uint8_t> compressed_buffer_in(read_size);
+    if (read_size > 0) {
+        RLECompressor::Leer_MPIIO(fh, read_offset, compressed_buffer_in.data(), read_size);
+    }
+    metricas.Registrar(Fase::Lectura, t_lectura.stop(), read_size);
+
+    Timer t_codificacion;
+    std::vector<uint8_t> local_decompressed_output = RLECompressor::Descomprimir_Local(compressed_buffer_in);
+    metricas.Registrar(Fase::Codificacion, t_codificacion.stop(), local_decompressed_output.size());
+
+    size_t decompressed_bytes_from_overlap = 0;
+
+    if (rank > 0 && overlap_read > 0) {
+        size_t c_idx = 0;
+
+        while (c_idx < overlap_read) {
+            uint8_t byte = compressed_buffer_in[c_idx];
+
+            if (byte == FLAG_RLE) {
+                if (c_idx + 3 <= overlap_read) {
+                    decompressed_bytes_from_overlap += compressed_buffer_in[c_idx + 1]; // Suma el CONTEO
+                    c_idx += 3;
+                } else {
+                    break;
+                }
+            } else if (byte == FLAG_LITERAL) {
+                if (c_idx + 2 <= overlap_read) {
+                    decompressed_bytes_from_overlap += 1;
+                    c_idx += 2;
+                } else {
+                    break;
+                }
+            } else {
+                decompressed_bytes_from_overlap += 1;
+                c_idx += 1;
+            }
+        }
+
+        if (decompressed_bytes_from_overlap > 0 && decompressed_bytes_from_overlap <= local_decompressed_output.size()) {
+            local_decompressed_output.erase(local_decompressed_output.begin(), local_decompressed_output.begin() + decompressed_bytes_from_overlap);
+        }
+    }
+    return local_decompressed_output;
+}
+
+// Formato de la compresión según las opciones: códec y, con CODEC_RLE_ELEMENTOS, el ancho de
+// elemento y la transposición a planos. Las pipelines copian esta corrida vacía al empezar.
+static RLECompressor::Corrida Formato_Corrida(const RLEOptions& opciones) {
+    RLECompressor::Corrida formato;
+    formato.codec = opciones.codec;
+    if (opciones.codec == RLEContainer::CODEC_RLE_ELEMENTOS) {
+        formato.elemento = max<size_t>(opciones.elemento, 1);
+        formato.planos = opciones.planos;
+    }
+    return formato;
+}
+
+// Redondea hacia abajo un tamaño de ventana o de trozo a un múltiplo del ancho de elemento (al menos
+// un elemento), para que ningún elemento quede partido entre dos segmentos.
+static size_t Alinear_Elemento(size_t n, size_t elemento) {
+    return max(n - n % elemento, elemento);
+}
+
+// Compresión por flujo del tramo [offset, offset + longitud) de `fh` en ventanas de `ventana` bytes.
+// Usa doble buffer: la lectura no bloqueante de la siguiente ventana (MPI_File_iread_at) se solapa con
+// la compresión de la actual. La corrida abierta al final de cada ventana pasa a la siguiente, por lo
+// que la salida es idéntica a Comprimir_Local sobre el tramo completo. Tras cada ventana se llama a
+// `consumir` (si existe), que puede retirar de `salida` los tokens ya completos. Con más de un hilo
+// en `pool` cada ventana se comprime por partes (Comprimir_Ventana_Paralela); solo este hilo llama a MPI.
+// La fase de lectura solo cuenta la espera por cada ventana, no la parte solapada con la compresión.
+static RLECompressor::Frontera Comprimir_Por_Ventanas(MPI_File fh, uint64_t offset, uint64_t longitud, size_t ventana, const RLECompressor::Corrida& formato, PoolHilos& pool, Metricas& metricas, vector<uint8_t>& salida, const function<void(vector<uint8_t>&)>& consumir) {
+    RLECompressor::Frontera frontera;
+    RLECompressor::Corrida corrida = formato;
+    if (longitud == 0) return frontera;
+
+    ventana = min<uint64_t>(max<size_t>(ventana, 1), min<uint64_t>(longitud, RLECompressor::TROZO_MAX_IO));
+    if (ventana < longitud) ventana = Alinear_Elemento(ventana, corrida.elemento);
+    vector<uint8_t> buffers[2] = {vector<uint8_t>(ventana), vector<uint8_t>(ventana)};
+    vector<vector<uint8_t>> parciales;
+    MPI_Request peticion;
+
+    auto iniciar_lectura = [&](int b, uint64_t posicion) {
+        int n = (int)min<uint64_t>(ventana, longitud - posicion);
+        MPI_File_iread_at(fh, offset + posicion, buffers[b].data(), n, MPI_UNSIGNED_CHAR, &peticion);
+    };
+
+    int actual = 0;
+    iniciar_lectura(actual, 0);
+    for (uint64_t posicion = 0; posicion < longitud; ) {
+        size_t n = min<uint64_t>(ventana, longitud - posicion);
+        Timer t_lectura;
+        MPI_Wait(&peticion, MPI_STATUS_IGNORE);
+
+        uint64_t siguiente = posicion + n;
+        if (siguiente < longitud) iniciar_lectura(1 - actual, siguiente);
+        metricas.Registrar(Fase::Lectura, t_lectura.stop(), n);
+
+        Timer t_codificacion;
+        RLECompressor::Actualizar_Frontera(frontera, buffers[actual].data(), n);
+        if (pool.Hilos() > 1) {
+            RLECompressor::Comprimir_Ventana_Paralela(pool, buffers[actual].data(), n, corrida, salida, parciales);
+        } else {
+            RLECompressor::Comprimir_Ventana(buffers[actual].data(), n, corrida, salida);
+        }
+        metricas.Registrar(Fase::Codificacion, t_codificacion.stop(), n);
+        if (consumir) consumir(salida);
+
+        posicion = siguiente;
+        actual = 1 - actual;
+    }
+    RLECompressor::Cerrar_Corrida(corrida, salida);
+    return frontera;
+}
+
+// Versión de Comprimir_Por_Ventanas para una entrada proyectada en memoria: las ventanas son vistas
+// de la proyección, sin copias ni buffers de lectura.
+static RLECompressor::Frontera Comprimir_Mapeado(const uint8_t* datos, uint64_t longitud, size_t ventana, const RLECompressor::Corrida& formato, PoolHilos& pool, Metricas& metricas, vector<uint8_t>& salida, const function<void(vector<uint8_t>&)>& consumir) {
+    RLECompressor::Frontera frontera;
+    RLECompressor::Corrida corrida = formato;
+    vector<vector<uint8_t>> parciales;
+    ventana = Alinear_Elemento(max<size_t>(ventana, 1), corrida.elemento);
+    for (uint64_t posicion = 0; posicion < longitud; posicion += ventana) {
+        size_t n = min<uint64_t>(ventana, longitud - posicion);
+        // Los fallos de página de la proyección se cuentan como codificación
+        Timer t_codificacion;
+        RLECompressor::Actualizar_Frontera(frontera, datos + posicion, n);
+        RLECompressor::Comprimir_Ventana_Paralela(pool, datos + posicion, n, corrida, salida, parciales);
+        metricas.Registrar(Fase::Codificacion, t_codificacion.stop(), n);
+        if (consumir) consumir(salida);
+    }
+    RLECompressor::Cerrar_Corrida(corrida, salida);
+    return frontera;
+}
+
+// Abre la salida de las versiones secuenciales: un ofstream o, con `directa`, un SalidaDirecta
+// (O_DIRECT). `os` queda asociado al buffer del que se abrió.
+static bool Abrir_Salida_Secuencial(const string& output_file, bool directa, ofstream& ofs, SalidaDirecta& salida_directa, ostream& os) {
+    if (directa) {
+        if (!salida_directa.Abrir(output_file)) return false;
+        os.rdbuf(&salida_directa);
+    } else {
+        ofs.open(output_file, ios::binary);
+        if (!ofs.is_open()) return false;
+        os.rdbuf(ofs.rdbuf());
+    }
+    return true;
+}
+
+static bool Cerrar_Salida_Secuencial(ofstream& ofs, SalidaDirecta& salida_directa, ostream& os) {
+    bool correcto = (bool)os.flush();
+    if (ofs.is_open()) {
+        ofs.close();
+        correcto = correcto && !ofs.fail();
+    } else {
+        correcto = salida_directa.Cerrar() && correcto;
+    }
+    return correcto;
+}
+
+// Cierra y borra una salida que quedó a medias (un contenedor sin índice ni pie o una descompresión
+// incompleta): no debe quedar en disco como si la operación hubiera terminado. stdout ("-") no se
+// puede retirar.
+static void Descartar_Salida(const string& output_file, ofstream& ofs, SalidaDirecta& salida_directa, ostream& os) {
+    if (output_file == "-") {
+        os.flush();
+        return;
+    }
+    Cerrar_Salida_Secuencial(ofs, salida_directa, os);
+    remove(output_file.c_str());
+}
+
+// Trozo de la entrada comprimido por un proceso en el reparto dinámico. La carga contiene solo tokens
+// completos, por lo que sus bloques se decodifican de forma independiente.
+struct TrozoComprimido {
+    uint64_t indice;
+    vector<uint8_t> carga;
+    vector<RLEContainer::Bloque> bloques;
+};
+
+// Reparto dinámico: el archivo se corta en trozos de `trozo` bytes y cada proceso reclama el siguiente
+// trozo libre incrementando un contador compartido (MPI_Fetch_and_op sobre una ventana RMA del rank 0)
+// hasta agotarlos. Así un proceso que termina antes sigue tomando trabajo en lugar de esperar al más lento.
+// Retorna los trozos comprimidos por este proceso y en `num_trozos` el total de trozos del archivo.
+static vector<TrozoComprimido> Comprimir_Dinamico(MPI_File fh, uint64_t total, size_t trozo, size_t ventana, const RLECompressor::Corrida& formato, PoolHilos& pool, Metricas& metricas, int rank, uint64_t& num_trozos) {
+    trozo = Alinear_Elemento(max<size_t>(trozo, 1), formato.elemento);
+    num_trozos = (total + trozo - 1) / trozo;
+
+    uint64_t* contador = nullptr;
+    MPI_Win win;
+    MPI_Win_allocate(rank == 0 ? sizeof(uint64_t) : 0, sizeof(uint64_t), MPI_INFO_NULL, MPI_COMM_WORLD, &contador, &win);
+    if (rank == 0) {
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, win);
+        *contador = 0;
+        MPI_Win_unlock(0, win);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    vector<TrozoComprimido> trozos;
+    const uint64_t uno = 1;
+    while (true) {
+        // El tiempo de reclamar un trozo se cuenta como coordinación entre procesos
+        Timer t_reclamo;
+        uint64_t k = 0;
+        MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, win);
+        MPI_Fetch_and_op(&uno, &k, MPI_UINT64_T, 0, 0, MPI_SUM, win);
+        MPI_Win_unlock(0, win);
+        metricas.Registrar(Fase::Fronteras, t_reclamo.stop(), 0);
+        if (k >= num_trozos) break;
+
+        uint64_t offset = k * trozo;
+        uint64_t longitud = min<uint64_t>(trozo, total - offset);
+        TrozoComprimido comprimido;
+        comprimido.indice = k;
+        RLECompressor::Frontera frontera = Comprimir_Por_Ventanas(fh, offset, longitud, ventana, formato, pool, metricas, comprimido.carga, nullptr);
+
+        Timer t_bloques;
+        comprimido.bloques = RLECompressor::Dividir_En_Bloques(comprimido.carga.data(), comprimido.carga.size(), RLECompressor::TAMANO_BLOQUE, formato.codec);
+        if (Combinar_Checksums(comprimido.bloques) != frontera.crc) {
+            cerr << "P" << rank << ": ERROR: Los bloques del trozo " << k << " no reproducen su entrada (CRC32C)." << endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        comprimido.carga.resize(RLECompressor::Almacenar_Bloques(comprimido.carga.data(), comprimido.bloques, formato.codec));
+        metricas.Registrar(Fase::Codificacion, t_bloques.stop(), 0);
+        trozos.push_back(std::move(comprimido));
+    }
+
+    MPI_Win_free(&win);
+    return trozos;
+}
+
+// Escritura colectiva del contenedor del reparto dinámico. Los bloques se ordenan por trozo, no por
+// proceso: una suma global de los bytes y bloques de cada trozo da su offset en el archivo y su
+// posición en el índice. El rank 0 escribe la cabecera, el registro FIN y el pie.
+// Retorna el tamaño total del archivo.
+static size_t Escribir_Contenedor_Dinamico(const string& output_file, const RLEContainer::Cabecera& cabecera, vector<TrozoComprimido>& trozos, uint64_t num_trozos, int rank) {
+    // [2k]: bytes de registros + cargas del trozo k, [2k + 1]: número de bloques del trozo k
+    vector<uint64_t> local(2 * num_trozos, 0), global(2 * num_trozos, 0);
+    for (const TrozoComprimido& t : trozos) {
+        local[2 * t.indice] = t.bloques.size() * RLEContainer::TAMANO_REGISTRO + t.carga.size();
+        local[2 * t.indice + 1] = t.bloques.size();
+    }
+    const uint64_t TROZO_SUMA = RLECompressor::TROZO_MAX_IO / sizeof(uint64_t);
+    for (uint64_t enviado = 0; enviado < local.size(); enviado += TROZO_SUMA) {
+        int n = (int)min<uint64_t>(local.size() - enviado, TROZO_SUMA);
+        MPI_Allreduce(local.data() + enviado, global.data() + enviado, n, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    }
+
+    // Prefijos: offset de datos y primer bloque de cada trozo
+    vector<uint64_t> offset_trozo(num_trozos + 1), primer_bloque(num_trozos + 1);
+    offset_trozo[0] = RLEContainer::TAMANO_CABECERA;
+    primer_bloque[0] = 0;
+    for (uint64_t k = 0; k < num_trozos; ++k) {
+        offset_trozo[k + 1] = offset_trozo[k] + global[2 * k];
+        primer_bloque[k + 1] = primer_bloque[k] + global[2 * k + 1];
+    }
+    uint64_t offset_fin = offset_trozo[num_trozos];
+    uint64_t offset_indice = offset_fin + RLEContainer::TAMANO_REGISTRO;
+    uint64_t num_bloques = primer_bloque[num_trozos];
+    uint64_t tamano_total = offset_indice + num_bloques * RLEContainer::TAMANO_ENTRADA_INDICE + RLEContainer::TAMANO_PIE;
+
+    size_t bloques_propios = 0;
+    for (const TrozoComprimido& t : trozos) bloques_propios += t.bloques.size();
+    vector<uint8_t> registros((bloques_propios + 1) * RLEContainer::TAMANO_REGISTRO);
+    uint8_t buffer_cabecera[RLEContainer::TAMANO_CABECERA];
+    uint8_t buffer_pie[RLEContainer::TAMANO_PIE];
+
+    vector<Tramo> tramos_datos, tramos_indice;
+    vector<vector<uint8_t>> entradas;
+    uint8_t* registro = registros.data();
+    if (rank == 0) {
+        RLEContainer::Serializar_Cabecera(cabecera, buffer_cabecera);
+        tramos_datos.push_back(Tramo{0, {Segmento(buffer_cabecera, RLEContainer::TAMANO_CABECERA)}});
+        RLEContainer::Bloque fin;
+        fin.tipo = RLEContainer::BLOQUE_FIN;
+        RLEContainer::Serializar_Registro(fin, registro);
+        tramos_datos.push_back(Tramo{(MPI_Offset)offset_fin, {Segmento(registro, RLEContainer::TAMANO_REGISTRO)}});
+        registro += RLEContainer::TAMANO_REGISTRO;
+        RLEContainer::Serializar_Pie(offset_indice, num_bloques, buffer_pie);
+        tramos_indice.push_back(Tramo{(MPI_Offset)(tamano_total - RLEContainer::TAMANO_PIE), {Segmento(buffer_pie, RLEContainer::TAMANO_PIE)}});
+    }
+    for (TrozoComprimido& t : trozos) {
+        RLEContainer::Asignar_Offsets(t.bloques, offset_trozo[t.indice]);
+        Tramo tramo{(MPI_Offset)offset_trozo[t.indice], {}};
+        const uint8_t* carga = t.carga.data();
+        for (const RLEContainer::Bloque& b : t.bloques) {
+            RLEContainer::Serializar_Registro(b, registro);
+            tramo.segmentos.push_back(Segmento(registro, RLEContainer::TAMANO_REGISTRO));
+            tramo.segmentos.push_back(Segmento(carga, b.longitud_comprimida));
+            registro += RLEContainer::TAMANO_REGISTRO;
+            carga += b.longitud_comprimida;
+        }
+        if (!tramo.segmentos.empty()) tramos_datos.push_back(std::move(tramo));
+
+        entradas.push_back(RLEContainer::Serializar_Entradas(t.bloques));
+        if (!entradas.back().empty()) {
+            MPI_Offset offset_entradas = offset_indice + primer_bloque[t.indice] * RLEContainer::TAMANO_ENTRADA_INDICE;
+            tramos_indice.push_back(Tramo{offset_entradas, {Segmento(entradas.back().data(), entradas.back().size())}});
+        }
+    }
+
+    MPI_File fh = Abrir_Salida_MPIIO(output_file, tamano_total, rank);
+    Escribir_Tramos_Colectivo(fh, tramos_datos, RLECompressor::TROZO_MAX_IO);
+    Escribir_Tramos_Colectivo(fh, tramos_indice, RLECompressor::TROZO_MAX_IO);
+    MPI_File_close(&fh);
+
+    return tamano_total;
+}
+
+bool RLECompressor::RunParallel(const std::string& input_file, const std::string& output_file, int rank, int size, const RLEOptions& opciones) {
+    Timer t;
+    MPI_File fh;
+
+    int error = MPI_File_open(MPI_COMM_WORLD, input_file.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+    if (error != MPI_SUCCESS) {
+        std::cerr << "P" << rank << ": Error al abrir el archivo: " << input_file << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    MPI_Offset file_size_mpi;
+    MPI_File_get_size(fh, &file_size_mpi);
+    size_t global_file_size = (size_t)file_size_mpi;
+
+    Metricas metricas;
+    PoolHilos pool(opciones.hilos);
+    RLEContainer::Cabecera cabecera;
+    cabecera.tamano_original = global_file_size;
+    cabecera.codec = opciones.codec;
+    cabecera.banderas |= RLEContainer::BANDERA_CRC32C;
+    Corrida formato = Formato_Corrida(opciones);
+
+    if (opciones.dinamico) {
+        // Los trozos se reclaman bajo demanda y cada uno se escribe en su posición: siempre colectivo
+        uint64_t num_trozos = 0;
+        vector<TrozoComprimido> trozos = Comprimir_Dinamico(fh, global_file_size, opciones.trozo_dinamico, opciones.ventana, formato, pool, metricas, rank, num_trozos);
+        MPI_File_close(&fh);
+
+        // Comprimir_Dinamico alinea los trozos al ancho de elemento
+        size_t trozo_dinamico = Alinear_Elemento(max<size_t>(opciones.trozo_dinamico, 1), formato.elemento);
+        uint64_t bytes_entrada = 0, bytes_salida = 0;
+        for (const TrozoComprimido& trozo : trozos) {
+            bytes_entrada += min<uint64_t>(trozo_dinamico, global_file_size - trozo.indice * trozo_dinamico);
+            bytes_salida += trozo.carga.size();
+        }
+
+        Timer t_escritura;
+        size_t total_compressed_size = Escribir_Contenedor_Dinamico(output_file, cabecera, trozos, num_trozos, rank);
+        metricas.Registrar(Fase::Escritura, t_escritura.stop(), bytes_salida);
+
+        uint64_t mis_trozos = trozos.size(), min_trozos = 0, max_trozos = 0;
+        MPI_Reduce(&mis_trozos, &min_trozos, 1, MPI_UINT64_T, MPI_MIN, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&mis_trozos, &max_trozos, 1, MPI_UINT64_T, MPI_MAX, 0, MPI_COMM_WORLD);
+
+        double elapsed = t.stop();
+        metricas.Registrar(Fase::Total, elapsed, bytes_entrada);
+        if (rank == 0) {
+            cout << "--- Resultado de Compresión Paralela (" << size << " P x " << pool.Hilos() << " H) ---" << endl;
+            cout << "Tiempo: " << fixed << setprecision(4) << elapsed << " s" << endl;
+            cout << "Tamaño Original: " << global_file_size << " B" << endl;
+            cout << "Tamaño Comprimido: " << total_compressed_size << " B" << endl;
+            cout << "Reparto Dinámico: " << num_trozos << " trozos de " << (trozo_dinamico >> 10)
+                 << " KiB, " << min_trozos << "-" << max_trozos << " por proceso" << endl;
+        }
+        if (!opciones.metricas.empty()) {
+            metricas.Reducir_Y_Escribir(opciones.metricas, "compresion", "paralelo_dinamico", pool.Hilos(), MPI_COMM_WORLD);
+        }
+        return true;
+    }
+
+    uint64_t offset_start = 0, chunk_size = 0;
+    Particion particion;
+    if (opciones.balanceo) {
+        particion = Calcular_Particion_Balanceada(fh, global_file_size, rank, size, formato.elemento);
+        offset_start = particion.cortes[rank];
+        chunk_size = particion.cortes[rank + 1] - offset_start;
+    } else {
+        Calcular_Particion(global_file_size, rank, size, offset_start, chunk_size, formato.elemento);
+    }
+
+    // El intercambio de fronteras se publica antes de comprimir cuando las muestras del inicio y del
+    // final del tramo bastan para resumirlo, y se completa después: la latencia queda oculta tras la
+    // codificación. Si una corrida ocupa toda su muestra se publica al terminar con la frontera exacta.
+    // Con Literales_En_Bloques cada tramo se codifica por separado y no hay nada que corregir: sin
+    // Preparar_Fronteras el intercambio queda vacío y Completar_Fronteras retorna 0.
+    bool corregir = size > 1 && !Literales_En_Bloques(opciones.codec);
+    IntercambioFronteras intercambio;
+    if (corregir) Preparar_Fronteras(intercambio, rank, size);
+    Timer t_muestras;
+    ResumenTramo anticipado;
+    bool anticipar = corregir && Resumir_Tramo_Anticipado(fh, offset_start, chunk_size, anticipado);
+    if (anticipar) Iniciar_Fronteras(intercambio, anticipado);
+    metricas.Registrar(Fase::Fronteras, t_muestras.stop(), 0);
+
+    // Solo se mantienen en memoria dos ventanas de entrada y la salida comprimida
+    vector<uint8_t> local_compressed_output;
+    auto progresar = [&](vector<uint8_t>&) { Progresar_Fronteras(intercambio); };
+    Frontera frontera = Comprimir_Por_Ventanas(fh, offset_start, chunk_size, opciones.ventana, formato, pool, metricas, local_compressed_output, progresar);
+    MPI_File_close(&fh);
+
+    Timer t_fronteras;
+    if (!anticipar) Iniciar_Fronteras(intercambio, Resumen_De_Frontera(frontera));
+    uint32_t crc_esperado = frontera.crc;
+    size_t inicio = Completar_Fronteras(local_compressed_output, intercambio, rank, size, opciones.codec, crc_esperado);
+    uint8_t* carga = local_compressed_output.data() + inicio;
+    size_t longitud_carga = local_compressed_output.size() - inicio;
+    metricas.Registrar(Fase::Fronteras, t_fronteras.stop(), longitud_carga);
+
+    // Tras la corrección cada proceso contiene solo tokens completos: se divide en bloques independientes
+    // y los que no se reducen se guardan sin codificar
+    Timer t_bloques;
+    vector<RLEContainer::Bloque> bloques_locales = Dividir_En_Bloques(carga, longitud_carga, TAMANO_BLOQUE, opciones.codec);
+    // Los checksums salen de los tokens: si no reproducen el CRC32C de la entrada, la codificación es errónea
+    if (Combinar_Checksums(bloques_locales) != crc_esperado) {
+        cerr << "P" << rank << ": ERROR: Los bloques comprimidos no reproducen la entrada del tramo (CRC32C)." << endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    longitud_carga = Almacenar_Bloques(carga, bloques_locales, opciones.codec);
+    metricas.Registrar(Fase::Codificacion, t_bloques.stop(), 0);
+
+    Timer t_escritura;
+    size_t total_compressed_size;
+    if (opciones.escritura == ModoEscritura::Colectiva) {
+        total_compressed_size = Escribir_Contenedor_Colectivo(output_file, cabecera, carga, bloques_locales, rank, size);
+    } else {
+        total_compressed_size = Escribir_Contenedor_Gather(output_file, cabecera, carga, longitud_carga, bloques_locales, rank, size);
+    }
+    metricas.Registrar(Fase::Escritura, t_escritura.stop(), longitud_carga);
+
+    double elapsed = t.stop();
+    metricas.Registrar(Fase::Total, elapsed, chunk_size);
+    if (rank == 0) {
+        cout << "--- Resultado de Compresión Paralela (" << size << " P x " << pool.Hilos() << " H) ---" << endl;
+        cout << "Tiempo: " << fixed << setprecision(4) << elapsed << " s" << endl;
+        cout << "Tamaño Original: " << global_file_size << " B" << endl;
+        cout << "Tamaño Comprimido: " << total_compressed_size << " B" << endl;
+        if (opciones.balanceo) {
+            cout << "Desbalance Estimado: " << setprecision(3) << particion.desbalance_uniforme
+                 << " (uniforme) -> " << particion.desbalance_balanceado << " (balanceado)" << endl;
+        }
+    }
+    if (!opciones.metricas.empty()) {
+        metricas.Reducir_Y_Escribir(opciones.metricas, "compresion", "paralelo", pool.Hilos(), MPI_COMM_WORLD);
+    }
+    return true;
+}
+
+// Escribe en `os` los bloques ya cerrados de los tokens de `salida` (con `final`, también el último)
+// y los retira del buffer. Agrega sus descriptores a `bloques` y su CRC32C a `crc`.
+// @return Bytes de carga escritos.
+static size_t Escribir_Bloques_Cerrados(ostream& os, vector<uint8_t>& salida, bool final, uint8_t codec, vector<RLEContainer::Bloque>& bloques, uint32_t& crc) {
+    vector<RLEContainer::Bloque> nuevos = RLECompressor::Dividir_En_Bloques(salida.data(), salida.size(), RLECompressor::TAMANO_BLOQUE, codec);
+    // El último bloque sigue abierto mientras no alcance el tamaño objetivo
+    if (!final && !nuevos.empty() && nuevos.back().longitud_original < RLECompressor::TAMANO_BLOQUE) {
+        nuevos.pop_back();
+    }
+    size_t usados = 0;
+    for (const RLEContainer::Bloque& b : nuevos) usados += b.longitud_comprimida;
+    size_t escritos = 0;
+    crc = Combinar_Checksums(nuevos, crc);
+    RLECompressor::Almacenar_Bloques(salida.data(), nuevos, codec);
+    for (const RLEContainer::Bloque& b : nuevos) {
+        RLEContainer::Escribir_Bloque(os, b, salida.data() + escritos);
+        escritos += b.longitud_comprimida;
+        bloques.push_back(b);
+    }
+    salida.erase(salida.begin(), salida.begin() + usados);
+    return escritos;
+}
+
+bool RLECompressor::RunSequential(const std::string& input_file, const std::string& output_file, const RLEOptions& opciones) {
+    Timer t;
+    MPI_File fh = MPI_FILE_NULL;
+    ArchivoMapeado mapa;
+    size_t size;
+
+    if (opciones.entrada_mapeada) {
+        if (!mapa.Abrir(input_file)) {
+            cerr << "ERROR: No se pudo proyectar el archivo de entrada: " << input_file << endl;
+            return false;
+        }
+        size = mapa.Longitud();
+    } else {
+        int error = MPI_File_open(MPI_COMM_SELF, input_file.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+        if (error != MPI_SUCCESS) {
+            cerr << "ERROR: No se pudo abrir el archivo de entrada: " << input_file << endl;
+            return false;
+        }
+
+        MPI_Offset file_size_mpi;
+        MPI_File_get_size(fh, &file_size_mpi);
+        size = (size_t)file_size_mpi;
+    }
+
+    ofstream ofs;
+    SalidaDirecta salida_directa;
+    ostream os(nullptr);
+    if (!Abrir_Salida_Secuencial(output_file, opciones.salida_directa, ofs, salida_directa, os)) {
+        cerr << "ERROR: No se pudo abrir el archivo de salida para escritura: " << output_file << endl;
+        if (fh != MPI_FILE_NULL) MPI_File_close(&fh);
+        return false;
+    }
+
+    Metricas metricas;
+    RLEContainer::Cabecera cabecera;
+    cabecera.tamano_original = size;
+    cabecera.codec = opciones.codec;
+    cabecera.banderas |= RLEContainer::BANDERA_CRC32C;
+    RLEContainer::Escribir_Cabecera(os, cabecera);
+
+    // Los bloques completos se escriben en cuanto se cierran: la memoria no depende del tamaño del archivo
+    vector<RLEContainer::Bloque> bloques;
+    size_t compressed_size = 0;
+    uint32_t crc_bloques = 0;
+    auto escribir_bloques = [&](vector<uint8_t>& salida, bool final) {
+        Timer t_escritura;
+        size_t escritos = Escribir_Bloques_Cerrados(os, salida, final, opciones.codec, bloques, crc_bloques);
+        compressed_size += escritos;
+        metricas.Registrar(Fase::Escritura, t_escritura.stop(), escritos);
+    };
+
+    PoolHilos pool(opciones.hilos);
+    vector<uint8_t> compressed;
+    auto consumir = [&](vector<uint8_t>& salida) { escribir_bloques(salida, false); };
+    Frontera frontera;
+    if (opciones.entrada_mapeada) {
+        frontera = Comprimir_Mapeado(mapa.Datos(), size, opciones.ventana, Formato_Corrida(opciones), pool, metricas, compressed, consumir);
+        mapa.Cerrar();
+    } else {
+        frontera = Comprimir_Por_Ventanas(fh, 0, size, opciones.ventana, Formato_Corrida(opciones), pool, metricas, compressed, consumir);
+        MPI_File_close(&fh);
+    }
+    escribir_bloques(compressed, true);
+    if (crc_bloques != frontera.crc) {
+        cerr << "ERROR: Los bloques comprimidos no reproducen la entrada (CRC32C): " << output_file << endl;
+        Descartar_Salida(output_file, ofs, salida_directa, os);
+        return false;
+    }
+
+    Timer t_cola;
+    RLEContainer::Escribir_Cola(os, bloques);
+    bool escrito = Cerrar_Salida_Secuencial(ofs, salida_directa, os);
+    metricas.Registrar(Fase::Escritura, t_cola.stop(), 0);
+    if (!escrito) {
+        cerr << "ERROR: Falló la escritura del archivo de salida: " << output_file << endl;
+        remove(output_file.c_str());
+        return false;
+    }
+
+    // El tiempo incluye la escritura, igual que en la versión paralela
+    double elapsed = t.stop();
+    metricas.Registrar(Fase::Total, elapsed, size);
+    cout << "--- Resultado de Compresión Secuencial (T1) ---" << endl;
+    cout << "Tiempo: " << fixed << setprecision(4) << elapsed << " s" << endl;
+    cout << "Tamaño Original: " << size << " B" << endl;
+    cout << "Tamaño Comprimido: " << Tamano_Contenedor(bloques.size(), compressed_size) << " B" << endl;
+    if (!opciones.metricas.empty()) {
+        metricas.Reducir_Y_Escribir(opciones.metricas, "compresion", "secuencial", pool.Hilos(), MPI_COMM_SELF);
+    }
+    return true;
+}
+
+bool RLECompressor::RunParallelDecompress(const std::string& input_file, const std::string& output_file, int rank, int size, const RLEOptions& opciones) {
+    Timer t;
+    MPI_File fh;
+    MPI_Offset compressed_file_size_mpi;
+
+    int error = MPI_File_open(MPI_COMM_WORLD, input_file.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+    if (error != MPI_SUCCESS) {
+        if (rank == 0) std::cerr << "P" << rank << ": Error al abrir el archivo comprimido: " << input_file << std::endl;
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
+    MPI_File_get_size(fh, &compressed_file_size_mpi);
+    size_t compressed_file_size = (size_t)compressed_file_size_mpi;
 
-    MPI_Offset file_size_mpi;
-    
-    MPI_File_get_size(fh, &file_size_mpi);
-    global_file_size = (size_t)file_size_mpi;
+    RLEContainer::Cabecera cabecera;
+    std::vector<RLEContainer::Bloque> bloques;
+    std::vector<uint8_t> local_decompressed_output;
+    size_t output_offset = 0;
 
-    size_t chunk_base_size = global_file_size / size;
-    size_t remainder = global_file_size % size;
-    
-    size_t my_chunk_size = chunk_base_size;
-    if ((size_t)rank < remainder) {
-        my_chunk_size += 1;
-    }
+    // La difusión del índice es el intercambio entre procesos de la descompresión
+    Metricas metricas;
+    Timer t_indice;
+    bool es_contenedor = Leer_Indice_MPIIO(fh, compressed_file_size_mpi, rank, cabecera, bloques);
+    metricas.Registrar(Fase::Fronteras, t_indice.stop(), 0);
 
-    offset_start = ((size_t)rank < remainder) 
-                   ? ((size_t)rank * (chunk_base_size + 1)) 
-                   : ((size_t)rank * chunk_base_size + remainder);
+    bool verificar = opciones.verificar && es_contenedor && (cabecera.banderas & RLEContainer::BANDERA_CRC32C);
+    if (opciones.verificar && !verificar && rank == 0) {
+        cerr << "ADVERTENCIA: El archivo no tiene checksums CRC32C por bloque; se descomprime sin verificar." << endl;
+    }
 
-    int extra_byte_to_read = (rank < size - 1) ? 1 : 0; 
-    size_t read_size = my_chunk_size + extra_byte_to_read;
-    
-    buffer_in.resize(read_size);
-    
-    MPI_File_read_at(fh, offset_start, buffer_in.data(), read_size, MPI_UNSIGNED_CHAR, MPI_STATUS_IGNORE);
-    
+    PoolHilos pool(es_contenedor ? opciones.hilos : 1);
+    if (es_contenedor) {
+        local_decompressed_output = Descomprimir_Contenedor_Paralelo(fh, bloques, cabecera.codec, verificar, pool, metricas, rank, size, output_offset);
+    } else {
+        local_decompressed_output = Descomprimir_Heredado_Paralelo(fh, compressed_file_size, metricas, rank, size);
+    }
     MPI_File_close(&fh);
-}
 
-void RLECompressor::Corregir_Fronteras(std::vector<uint8_t>& local_output, const std::vector<uint8_t>& buffer_leido, size_t chunk_size, int rank, int size) {
-    if (size == 1) return;
-    
-    uint8_t my_last_byte = (chunk_size > 0) ? buffer_leido[chunk_size - 1] : 0;
-    uint8_t last_byte_prev = 0; 
-    uint8_t first_byte_mine = (chunk_size > 0) ? buffer_leido[0] : 0; 
-    const int FUSION_TAG = FRONTERA_TAG + 1;
+    Timer t_offsets;
+    uint64_t local_len = local_decompressed_output.size();
+    uint64_t total_decompressed_size = 0;
+    MPI_Allreduce(&local_len, &total_decompressed_size, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
 
-    if (rank < size - 1) { 
-        MPI_Send(&my_last_byte, 1, MPI_UNSIGNED_CHAR, rank + 1, FRONTERA_TAG, MPI_COMM_WORLD);
+    // En el formato heredado el offset de salida se obtiene con un prefijo exclusivo
+    if (opciones.escritura == ModoEscritura::Colectiva && !es_contenedor) {
+        uint64_t previo = 0;
+        MPI_Exscan(&local_len, &previo, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+        output_offset = (rank == 0) ? 0 : previo;
     }
-    if (rank > 0) { 
-        MPI_Recv(&last_byte_prev, 1, MPI_UNSIGNED_CHAR, rank - 1, FRONTERA_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    }
-    
-    
-    int fusion_length_to_prev = 0; 
-    
-    if (rank > 0 && last_byte_prev == first_byte_mine) {
-        size_t k = 0;
-        while (k < chunk_size && buffer_leido[k] == first_byte_mine && k < 255) {
-             k++;
-        }
-        fusion_length_to_prev = (int)k; 
+    metricas.Registrar(Fase::Fronteras, t_offsets.stop(), 0);
+
+    Timer t_escritura;
+    if (opciones.escritura == ModoEscritura::Colectiva) {
+        Escribir_Salida_Colectiva(output_file, local_decompressed_output, output_offset, total_decompressed_size, rank);
+    } else {
+        Escribir_Salida_Gather(output_file, local_decompressed_output, rank, size);
     }
-    
-    
-    int fusion_length_from_next = 0;
+    metricas.Registrar(Fase::Escritura, t_escritura.stop(), local_len);
 
-    if (rank > 0) { 
-        MPI_Send(&fusion_length_to_prev, 1, MPI_INT, rank - 1, FUSION_TAG, MPI_COMM_WORLD);
+    double elapsed = t.stop();
+    metricas.Registrar(Fase::Total, elapsed, local_len);
+    if (rank == 0) {
+        std::cout << "\n--- Resultado de Descompresión Paralela (" << size << " P x " << pool.Hilos() << " H) ---" << std::endl;
+        std::cout << "Tiempo: " << std::fixed << std::setprecision(4) << elapsed << " s" << std::endl;
+        std::cout << "Tamaño Comprimido: " << compressed_file_size << " B" << std::endl;
+        std::cout << "Tamaño Descomprimido: " << total_decompressed_size << " B" << std::endl;
+        if (verificar) std::cout << "Verificación CRC32C: " << bloques.size() << " bloques correctos" << std::endl;
     }
-    if (rank < size - 1) { 
-        MPI_Recv(&fusion_length_from_next, 1, MPI_INT, rank + 1, FUSION_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    if (!opciones.metricas.empty()) {
+        metricas.Reducir_Y_Escribir(opciones.metricas, "descompresion", "paralelo", pool.Hilos(), MPI_COMM_WORLD);
     }
-    
-    
-    if (fusion_length_from_next > 0 && !local_output.empty()) {
-        
-        if (local_output.size() >= 3 && local_output[local_output.size() - 3] == FLAG_RLE) {
-            
-            uint16_t new_count = (uint16_t)local_output[local_output.size() - 2] + fusion_length_from_next;
-            
-            if (new_count <= 255) {
-                 local_output[local_output.size() - 2] = (uint8_t)new_count;
-            } else {
-                 local_output[local_output.size() - 2] = 255;
-            }
-            
-        } 
-        else { 
-            if (local_output.back() == my_last_byte) {
-                
-                uint8_t literal_char = local_output.back();
-                int literal_len = 0; 
-                
-                size_t i = local_output.size();
-                while (i > 0) {
-                    uint8_t code = local_output[i - 1];
-                    
-                    if (code == literal_char) {
-                        literal_len++;
-                        i--;
-                    } else if (code == FLAG_LITERAL && i > 1 && local_output[i - 2] != FLAG_RLE) {
-                         if (local_output[i-1] == literal_char) {
-                             literal_len++;
-                             i -= 2;
-                         } else {
-                             break;
-                         }
-                    } else {
-                        break;
-                    }
-                }
+    return true;
+}
 
-                local_output.erase(local_output.begin() + i, local_output.end());
-                
-                uint16_t new_count = (uint16_t)literal_len + fusion_length_from_next;
-                
-                if (new_count >= RLE_THRESHOLD) {
-                    local_output.push_back(FLAG_RLE);
-                    local_output.push_back((uint8_t)new_count);
-                    local_output.push_back(literal_char);
-                } else {
-                    for (int n = 0; n < new_count; ++n) {
-                         if (literal_char == FLAG_RLE || literal_char == FLAG_LITERAL) {
-                            local_output.push_back(FLAG_LITERAL);
-                         }
-                         local_output.push_back(literal_char);
-                    }
-                }
-            }
+bool RLECompressor::RunSequentialDecompress(const std::string& input_file, const std::string& output_file, const RLEOptions& opciones) {
+    Timer t;
+    Timer t_lectura;
+    // Con --mmap los bloques se decodifican directamente desde la proyección del archivo
+    ArchivoMapeado mapa;
+    vector<uint8_t> buffer;
+    const uint8_t* entrada;
+    size_t size;
+
+    if (opciones.entrada_mapeada) {
+        if (!mapa.Abrir(input_file)) {
+            cerr << "ERROR: No se pudo proyectar el archivo comprimido: " << input_file << endl;
+            return false;
+        }
+        entrada = mapa.Datos();
+        size = mapa.Longitud();
+    } else {
+        ifstream is(input_file, ios::binary | ios::ate);
+        if (!is.is_open()) {
+            cerr << "ERROR: No se pudo abrir el archivo comprimido: " << input_file << endl;
+            return false;
         }
+
+        size = is.tellg();
+        is.seekg(0, ios::beg);
+
+        buffer.resize(size);
+        is.read((char*)buffer.data(), size);
+        is.close();
+        entrada = buffer.data();
     }
-    
-    if (fusion_length_to_prev > 0) {
-        
-        if (local_output.empty()) return;
-
-        int absorbed_length = 0;
-        
-        while (absorbed_length < fusion_length_to_prev && !local_output.empty()) {
-            uint8_t first_code = local_output[0];
-            
-            if (first_code == FLAG_RLE) {
-                absorbed_length += local_output[1];
-                local_output.erase(local_output.begin(), local_output.begin() + 3);
-                
-            } else if (first_code == FLAG_LITERAL) {
-                absorbed_length += 1;
-                local_output.erase(local_output.begin(), local_output.begin() + 2);
-                
-            } else {
-                absorbed_length += 1;
-                local_output.erase(local_output.begin());
+    Metricas metricas;
+    metricas.Registrar(Fase::Lectura, t_lectura.stop(), size);
+
+    Timer t_codificacion;
+    PoolHilos pool(opciones.hilos);
+    vector<uint8_t> decompressed;
+    RLEContainer::Cabecera cabecera;
+    vector<RLEContainer::Bloque> bloques;
+    bool es_contenedor = RLEContainer::Parsear(entrada, size, cabecera, bloques);
+    bool verificar = opciones.verificar && es_contenedor && (cabecera.banderas & RLEContainer::BANDERA_CRC32C);
+    if (opciones.verificar && !verificar) {
+        cerr << "ADVERTENCIA: El archivo no tiene checksums CRC32C por bloque; se descomprime sin verificar." << endl;
+    }
+
+    if (es_contenedor) {
+        uint64_t total = 0;
+        for (const RLEContainer::Bloque& b : bloques) total += b.longitud_original;
+        decompressed.resize(total);
+
+        // Cada bloque se descomprime directamente en su posición de la salida (en paralelo si hay hilos)
+        vector<uint64_t> posiciones(bloques.size(), 0);
+        for (size_t i = 1; i < bloques.size(); ++i) {
+            posiciones[i] = posiciones[i - 1] + bloques[i - 1].longitud_original;
+        }
+
+        vector<uint8_t> correcto(bloques.size(), 0);
+        pool.Ejecutar(bloques.size(), [&](size_t i) {
+            const uint8_t* inicio = entrada + bloques[i].offset + RLEContainer::TAMANO_REGISTRO;
+            correcto[i] = Descomprimir_Bloque(bloques[i], inicio, decompressed.data() + posiciones[i], cabecera.codec, verificar);
+        });
+
+        for (size_t i = 0; i < bloques.size(); ++i) {
+            if (!correcto[i]) {
+                cerr << "ERROR: Bloque " << i << " corrupto en el archivo comprimido: " << input_file << endl;
+                return false;
             }
         }
+    } else {
+        // Formato heredado: flujo RLE sin cabecera
+        decompressed.resize(Longitud_Descomprimida(entrada, size));
+        Descomprimir_Local(entrada, size, decompressed.data(), decompressed.size());
     }
-}
+    mapa.Cerrar();
+    metricas.Registrar(Fase::Codificacion, t_codificacion.stop(), decompressed.size());
 
-void RLECompressor::RunParallel(const std::string& input_file, const std::string& output_file, int rank, int size) {
-    Timer t;
-    size_t global_file_size = 0;
-    size_t offset_start = 0;
-    vector<uint8_t> buffer_in;
-    
-    Leer_Bloque_MPIIO(input_file, rank, size, buffer_in, global_file_size, offset_start);
-    
-    size_t chunk_size = buffer_in.size();
-    if (rank < size - 1) {
-        chunk_size--;
+    Timer t_escritura;
+    ofstream ofs;
+    SalidaDirecta salida_directa;
+    ostream os(nullptr);
+    if (!Abrir_Salida_Secuencial(output_file, opciones.salida_directa, ofs, salida_directa, os)) {
+        cerr << "ERROR: No se pudo abrir el archivo de salida para escritura: " << output_file << endl;
+        return false;
     }
+    os.write((const char*)decompressed.data(), decompressed.size());
+    if (!Cerrar_Salida_Secuencial(ofs, salida_directa, os)) {
+        cerr << "ERROR: Falló la escritura del archivo de salida: " << output_file << endl;
+        return false;
+    }
+    metricas.Registrar(Fase::Escritura, t_escritura.stop(), decompressed.size());
 
-    vector<uint8_t> data_to_compress(buffer_in.begin(), buffer_in.begin() + chunk_size);
-    vector<uint8_t> local_compressed_output = Comprimir_Local(data_to_compress);
+    double elapsed = t.stop();
+    metricas.Registrar(Fase::Total, elapsed, decompressed.size());
+    cout << "--- Resultado de Descompresión Secuencial (T1) ---" << endl;
+    cout << "Tiempo: " << fixed << setprecision(4) << elapsed << " s" << endl;
+    cout << "Tamaño Comprimido: " << size << " B" << endl;
+    cout << "Tamaño Descomprimido: " << decompressed.size() << " B" << endl;
+    if (verificar) cout << "Verificación CRC32C: " << bloques.size() << " bloques correctos" << endl;
+    if (!opciones.metricas.empty()) {
+        metricas.Reducir_Y_Escribir(opciones.metricas, "descompresion", "secuencial", pool.Hilos(), MPI_COMM_SELF);
+    }
+    return true;
+}
 
-    Corregir_Fronteras(local_compressed_output, buffer_in, chunk_size, rank, size);
-    
-    int local_len = local_compressed_output.size();
-    vector<int> global_lengths(size);
-    
-    MPI_Gather(&local_len, 1, MPI_INT, global_lengths.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+// Abre la entrada de las versiones por flujo: stdin con "-" o el archivo. Retorna -1 si falla.
+static int Abrir_Entrada_Flujo(const string& input_file) {
+    return input_file == "-" ? STDIN_FILENO : open(input_file.c_str(), O_RDONLY);
+}
 
-    vector<int> displacements(size, 0);
-    size_t total_compressed_size = 0;
-    vector<uint8_t> global_compressed_output;
+static void Cerrar_Entrada_Flujo(int fd) {
+    if (fd != STDIN_FILENO) close(fd);
+}
 
-    if (rank == 0) {
-        for (int i = 0; i < size; ++i) {
-            displacements[i] = (i > 0) ? (displacements[i-1] + global_lengths[i-1]) : 0;
-            total_compressed_size += global_lengths[i];
-        }
-        global_compressed_output.resize(total_compressed_size);
+// Abre la salida de las versiones por flujo: stdout con "-" o la salida secuencial (con --direct).
+static bool Abrir_Salida_Flujo(const string& output_file, bool directa, ofstream& ofs, SalidaDirecta& salida_directa, ostream& os) {
+    if (output_file == "-") {
+        os.rdbuf(cout.rdbuf());
+        return true;
     }
-    
-    MPI_Gatherv(
-        local_compressed_output.data(), local_len, MPI_UNSIGNED_CHAR,
-        global_compressed_output.data(), global_lengths.data(), displacements.data(), 
-        MPI_UNSIGNED_CHAR, 0, MPI_COMM_WORLD
-    );
+    return Abrir_Salida_Secuencial(output_file, directa, ofs, salida_directa, os);
+}
 
-    if (rank == 0) {
-        double elapsed = t.stop();
-        cout << "--- Resultado de Compresión Paralela (" << size << " P) ---" << endl;
-        cout << "Tiempo: " << fixed << setprecision(4) << elapsed << " s" << endl;
-        cout << "Tamaño Original: " << global_file_size << " B" << endl;
-        cout << "Tamaño Comprimido: " << total_compressed_size << " B" << endl;
+static bool Cerrar_Salida_Flujo(const string& output_file, ofstream& ofs, SalidaDirecta& salida_directa, ostream& os) {
+    if (output_file == "-") return (bool)os.flush();
+    return Cerrar_Salida_Secuencial(ofs, salida_directa, os);
+}
 
-        ofstream ofs(output_file, ios::binary);
-        if (ofs.is_open()) {
-            ofs.write((const char*)global_compressed_output.data(), total_compressed_size);
-            ofs.close();
-        } else {
-            cerr << "P0: ERROR al abrir el archivo de salida para escritura: " << output_file << endl;
-        }
+// Lee hasta `n` bytes; de una tubería read() retorna lo que haya disponible. -1 si hay un error.
+static ssize_t Leer_Flujo(int fd, uint8_t* destino, size_t n) {
+    while (true) {
+        ssize_t leidos = read(fd, destino, n);
+        if (leidos >= 0 || errno != EINTR) return leidos;
+    }
+}
+
+// Lee exactamente `n` bytes. Retorna false si el flujo termina antes o hay un error.
+static bool Leer_Flujo_Exacto(int fd, uint8_t* destino, size_t n) {
+    while (n > 0) {
+        ssize_t leidos = Leer_Flujo(fd, destino, n);
+        if (leidos <= 0) return false;
+        destino += leidos;
+        n -= (size_t)leidos;
+    }
+    return true;
+}
+
+// Lee la carga de `n` bytes de un bloque. El buffer crece por tramos de TAMANO_BLOQUE a medida que
+// llegan los datos: una longitud corrupta agota el flujo antes de reservar memoria que no existe.
+static bool Leer_Carga_Flujo(int fd, vector<uint8_t>& carga, uint64_t n) {
+    carga.clear();
+    while (carga.size() < n) {
+        size_t inicio = carga.size();
+        carga.resize(inicio + min<uint64_t>(n - inicio, RLECompressor::TAMANO_BLOQUE));
+        if (!Leer_Flujo_Exacto(fd, carga.data() + inicio, carga.size() - inicio)) return false;
     }
+    return true;
 }
 
-void RLECompressor::RunSequential(const std::string& input_file, const std::string& output_file) {
+// Sin índice que acote los registros, se validan como en Descomprimir_Bloque antes de reservar nada:
+// un tipo conocido, un bloque almacenado con ambas longitudes iguales y una carga RLE dentro de la
+// cota de MaxCompressedSize.
+static bool Registro_Valido(const RLEContainer::Bloque& b, uint8_t codec) {
+    if (b.tipo == RLEContainer::BLOQUE_ALMACENADO) return b.longitud_comprimida == b.longitud_original;
+    if (b.tipo != RLEContainer::BLOQUE_RLE) return false;
+    return b.longitud_original <= (UINT64_MAX >> 2) &&
+           b.longitud_comprimida <= RLECompressor::MaxCompressedSize(b.longitud_original, codec);
+}
+
+bool RLECompressor::RunStreamCompress(const std::string& input_file, const std::string& output_file, const RLEOptions& opciones) {
     Timer t;
-    ifstream is(input_file, ios::binary | ios::ate);
-    if (!is.is_open()) {
+    int fd = Abrir_Entrada_Flujo(input_file);
+    if (fd < 0) {
         cerr << "ERROR: No se pudo abrir el archivo de entrada: " << input_file << endl;
-        return;
+        return false;
     }
 
-    size_t size = is.tellg();
-    is.seekg(0, ios::beg);
+    ofstream ofs;
+    SalidaDirecta salida_directa;
+    ostream os(nullptr);
+    if (!Abrir_Salida_Flujo(output_file, opciones.salida_directa, ofs, salida_directa, os)) {
+        cerr << "ERROR: No se pudo abrir el archivo de salida para escritura: " << output_file << endl;
+        Cerrar_Entrada_Flujo(fd);
+        return false;
+    }
 
-    vector<uint8_t> buffer(size);
-    is.read((char*)buffer.data(), size);
-    is.close();
+    // El tamaño de la entrada no se conoce hasta el final: queda implícito en los bloques
+    Metricas metricas;
+    RLEContainer::Cabecera cabecera;
+    cabecera.codec = opciones.codec;
+    cabecera.banderas |= RLEContainer::BANDERA_CRC32C | RLEContainer::BANDERA_TAMANO_EN_INDICE;
+    RLEContainer::Escribir_Cabecera(os, cabecera);
+    os.flush();
 
-    vector<uint8_t> compressed = Comprimir_Local(buffer);
+    vector<RLEContainer::Bloque> bloques;
+    size_t compressed_size = 0;
+    uint32_t crc_bloques = 0;
+    vector<uint8_t> compressed;
+    auto escribir_bloques = [&](bool final) {
+        Timer t_escritura;
+        size_t escritos = Escribir_Bloques_Cerrados(os, compressed, final, opciones.codec, bloques, crc_bloques);
+        compressed_size += escritos;
+        if (escritos > 0) os.flush();
+        metricas.Registrar(Fase::Escritura, t_escritura.stop(), escritos);
+    };
 
-    double elapsed = t.stop();
-    cout << "--- Resultado de Compresión Secuencial (T1) ---" << endl;
-    cout << "Tiempo: " << fixed << setprecision(4) << elapsed << " s" << endl;
-    cout << "Tamaño Original: " << size << " B" << endl;
-    cout << "Tamaño Comprimido: " << compressed.size() << " B" << endl;
+    // Con rle y varint la corrida abierta pasa de una lectura a la siguiente sin cambiar la salida: se
+    // codifica en cuanto hay un bloque de entrada, lo mínimo que se puede emitir. Con literales y
+    // elementos los grupos se cortan en el borde de cada ventana, así que solo se codifican ventanas
+    // completas (salvo al final), las mismas de Comprimir_Por_Ventanas: la salida no depende de cómo
+    // llegue la entrada por la tubería y coincide con la de --secuencial.
+    PoolHilos pool(opciones.hilos);
+    Corrida corrida = Formato_Corrida(opciones);
+    Frontera frontera;
+    vector<vector<uint8_t>> parciales;
+    size_t capacidad = Alinear_Elemento(min(max<size_t>(opciones.ventana, 1), TROZO_MAX_IO), corrida.elemento);
+    bool ventanas_fijas = Literales_En_Bloques(corrida.codec);
+    size_t umbral = ventanas_fijas ? capacidad : min(capacidad, TAMANO_BLOQUE);
+    vector<uint8_t> buffer(capacidad);
+    size_t lleno = 0;
+    uint64_t size = 0;
+    bool fin = false;
 
-    ofstream ofs(output_file, ios::binary);
-    if (ofs.is_open()) {
-        ofs.write((const char*)compressed.data(), compressed.size());
-        ofs.close();
-    } else {
-        cerr << "ERROR: No se pudo abrir el archivo de salida para escritura: " << output_file << endl;
+    while (!fin) {
+        Timer t_lectura;
+        ssize_t leidos = Leer_Flujo(fd, buffer.data() + lleno, capacidad - lleno);
+        if (leidos < 0) {
+            cerr << "ERROR: Falló la lectura de la entrada: " << input_file << endl;
+            Cerrar_Entrada_Flujo(fd);
+            Descartar_Salida(output_file, ofs, salida_directa, os);
+            return false;
+        }
+        fin = (leidos == 0);
+        lleno += (size_t)leidos;
+        metricas.Registrar(Fase::Lectura, t_lectura.stop(), (uint64_t)leidos);
+        if ((!fin && lleno < umbral) || lleno == 0) continue;
+
+        // Solo el códec de elementos usa elementos de varios bytes, y sus ventanas están alineadas
+        size_t n = lleno;
+        Timer t_codificacion;
+        Actualizar_Frontera(frontera, buffer.data(), n);
+        if (pool.Hilos() > 1) {
+            Comprimir_Ventana_Paralela(pool, buffer.data(), n, corrida, compressed, parciales);
+        } else {
+            Comprimir_Ventana(buffer.data(), n, corrida, compressed);
+        }
+        metricas.Registrar(Fase::Codificacion, t_codificacion.stop(), n);
+        lleno = 0;
+        size += n;
+        escribir_bloques(false);
+    }
+    Cerrar_Entrada_Flujo(fd);
+
+    Cerrar_Corrida(corrida, compressed);
+    escribir_bloques(true);
+    if (crc_bloques != frontera.crc) {
+        cerr << "ERROR: Los bloques comprimidos no reproducen la entrada (CRC32C): " << output_file << endl;
+        Descartar_Salida(output_file, ofs, salida_directa, os);
+        return false;
+    }
+
+    Timer t_cola;
+    RLEContainer::Escribir_Cola(os, bloques);
+    bool escrito = Cerrar_Salida_Flujo(output_file, ofs, salida_directa, os);
+    metricas.Registrar(Fase::Escritura, t_cola.stop(), 0);
+    if (!escrito) {
+        cerr << "ERROR: Falló la escritura del archivo de salida: " << output_file << endl;
+        if (output_file != "-") remove(output_file.c_str());
+        return false;
+    }
+
+    // stdout puede ser la salida comprimida: el resumen va a cerr
+    double elapsed = t.stop();
+    metricas.Registrar(Fase::Total, elapsed, size);
+    cerr << "--- Resultado de Compresión por Flujo ---" << endl;
+    cerr << "Tiempo: " << fixed << setprecision(4) << elapsed << " s" << endl;
+    cerr << "Tamaño Original: " << size << " B" << endl;
+    cerr << "Tamaño Comprimido: " << Tamano_Contenedor(bloques.size(), compressed_size) << " B" << endl;
+    if (!opciones.metricas.empty()) {
+        metricas.Reducir_Y_Escribir(opciones.metricas, "compresion", "flujo", pool.Hilos(), MPI_COMM_SELF);
     }
+    return true;
 }
 
-void RLECompressor::RunParallelDecompress(const std::string& input_file, const std::string& output_file, int rank, int size) {
+bool RLECompressor::RunStreamDecompress(const std::string& input_file, const std::string& output_file, const RLEOptions& opciones) {
     Timer t;
-    MPI_File fh;
-    MPI_Offset compressed_file_size_mpi;
-    
-    int error = MPI_File_open(MPI_COMM_WORLD, input_file.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
-    if (error != MPI_SUCCESS) {
-        if (rank == 0) std::cerr << "P" << rank << ": Error al abrir el archivo comprimido: " << input_file << std::endl;
-        MPI_Abort(MPI_COMM_WORLD, 1);
+    int fd = Abrir_Entrada_Flujo(input_file);
+    if (fd < 0) {
+        cerr << "ERROR: No se pudo abrir el archivo comprimido: " << input_file << endl;
+        return false;
     }
-    MPI_File_get_size(fh, &compressed_file_size_mpi);
-    size_t compressed_file_size = (size_t)compressed_file_size_mpi;
 
-    size_t chunk_base_size = compressed_file_size / size;
-    size_t remainder = compressed_file_size % size;
-    size_t my_chunk_size = chunk_base_size + ((size_t)rank < remainder ? 1 : 0);
-    
-    size_t offset_start = ((size_t)rank < remainder) 
-                   ? ((size_t)rank * (chunk_base_size + 1)) 
-                   : ((size_t)rank * chunk_base_size + remainder);
-
-    const size_t OVERLAP_BYTES = 2; 
-    size_t overlap_read = 0;
-    MPI_Offset read_offset = offset_start;
-    
-    if (rank > 0) {
-        if (offset_start >= OVERLAP_BYTES) {
-            read_offset -= OVERLAP_BYTES;
-            overlap_read = OVERLAP_BYTES;
-        } else {
-            read_offset = 0;
-            overlap_read = offset_start;
-        }
+    uint8_t buffer_cabecera[RLEContainer::TAMANO_CABECERA];
+    RLEContainer::Cabecera cabecera;
+    if (!Leer_Flujo_Exacto(fd, buffer_cabecera, RLEContainer::TAMANO_CABECERA) ||
+        !RLEContainer::Parsear_Cabecera(buffer_cabecera, cabecera)) {
+        cerr << "ERROR: La entrada no es un contenedor RLE (el formato heredado no se puede leer por flujo): " << input_file << endl;
+        Cerrar_Entrada_Flujo(fd);
+        return false;
     }
-    
-    size_t read_size = my_chunk_size + overlap_read;
-    
-    std::vector<uint8_t> compressed_buffer_in(read_size);
-    if (read_size > 0) {
-        MPI_File_read_at(fh, read_offset, compressed_buffer_in.data(), read_size, MPI_UNSIGNED_CHAR, MPI_STATUS_IGNORE);
+    bool verificar = opciones.verificar && (cabecera.banderas & RLEContainer::BANDERA_CRC32C);
+    if (opciones.verificar && !verificar) {
+        cerr << "ADVERTENCIA: El archivo no tiene checksums CRC32C por bloque; se descomprime sin verificar." << endl;
     }
-    MPI_File_close(&fh);
 
-    std::vector<uint8_t> local_decompressed_output = Descomprimir_Local(compressed_buffer_in);
-    
-    size_t decompressed_bytes_from_overlap = 0;
-    
-    if (rank > 0 && overlap_read > 0) {
-        size_t c_idx = 0;
-        
-        while (c_idx < overlap_read) {
-            uint8_t byte = compressed_buffer_in[c_idx];
+    ofstream ofs;
+    SalidaDirecta salida_directa;
+    ostream os(nullptr);
+    if (!Abrir_Salida_Flujo(output_file, opciones.salida_directa, ofs, salida_directa, os)) {
+        cerr << "ERROR: No se pudo abrir el archivo de salida para escritura: " << output_file << endl;
+        Cerrar_Entrada_Flujo(fd);
+        return false;
+    }
 
-            if (byte == FLAG_RLE) {
-                if (c_idx + 3 <= overlap_read) {
-                    decompressed_bytes_from_overlap += compressed_buffer_in[c_idx + 1]; // Suma el CONTEO
-                    c_idx += 3;
-                } else {
-                    break;
-                }
-            } else if (byte == FLAG_LITERAL) {
-                if (c_idx + 2 <= overlap_read) {
-                    decompressed_bytes_from_overlap += 1;
-                    c_idx += 2;
-                } else {
-                    break;
-                }
-            } else {
-                decompressed_bytes_from_overlap += 1;
-                c_idx += 1;
+    // Se leen hasta `hilos` bloques, se decodifican en paralelo y se escriben en orden
+    Metricas metricas;
+    PoolHilos pool(opciones.hilos);
+    size_t lote_maximo = pool.Hilos();
+    vector<RLEContainer::Bloque> lote;
+    vector<vector<uint8_t>> cargas(lote_maximo), salidas(lote_maximo);
+    vector<uint8_t> correcto(lote_maximo);
+    uint64_t leidos = RLEContainer::TAMANO_CABECERA;
+    uint64_t num_bloques = 0;
+    uint64_t total = 0;
+    bool fin = false;
+
+    while (!fin) {
+        Timer t_lectura;
+        lote.clear();
+        while (lote.size() < lote_maximo) {
+            uint8_t registro[RLEContainer::TAMANO_REGISTRO];
+            bool completo = Leer_Flujo_Exacto(fd, registro, RLEContainer::TAMANO_REGISTRO);
+            RLEContainer::Bloque b = RLEContainer::Parsear_Registro(registro);
+            if (completo && b.tipo == RLEContainer::BLOQUE_FIN) {
+                leidos += RLEContainer::TAMANO_REGISTRO;
+                fin = true;
+                break;
             }
+            if (completo && !Registro_Valido(b, cabecera.codec)) {
+                cerr << "ERROR: Registro del bloque " << num_bloques + lote.size() << " inválido en el archivo comprimido: " << input_file << endl;
+                Cerrar_Entrada_Flujo(fd);
+                Descartar_Salida(output_file, ofs, salida_directa, os);
+                return false;
+            }
+            completo = completo && Leer_Carga_Flujo(fd, cargas[lote.size()], b.longitud_comprimida);
+            if (!completo) {
+                cerr << "ERROR: El flujo comprimido termina antes del registro final: " << input_file << endl;
+                Cerrar_Entrada_Flujo(fd);
+                Descartar_Salida(output_file, ofs, salida_directa, os);
+                return false;
+            }
+            // La longitud original se contrasta con los tokens antes de reservar la salida del bloque
+            if (b.tipo == RLEContainer::BLOQUE_RLE &&
+                Longitud_Descomprimida(cargas[lote.size()].data(), b.longitud_comprimida, cabecera.codec) != b.longitud_original) {
+                cerr << "ERROR: Bloque " << num_bloques + lote.size() << " corrupto en el archivo comprimido: " << input_file << endl;
+                Cerrar_Entrada_Flujo(fd);
+                Descartar_Salida(output_file, ofs, salida_directa, os);
+                return false;
+            }
+            leidos += RLEContainer::TAMANO_REGISTRO + b.longitud_comprimida;
+            lote.push_back(b);
         }
-        
-        if (decompressed_bytes_from_overlap > 0 && decompressed_bytes_from_overlap <= local_decompressed_output.size()) {
-            local_decompressed_output.erase(local_decompressed_output.begin(), local_decompressed_output.begin() + decompressed_bytes_from_overlap);
-        }
-    }
-    
-    int local_len = local_decompressed_output.size();
-    std::vector<int> global_lengths(size);
-    
-    MPI_Gather(&local_len, 1, MPI_INT, global_lengths.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+        metricas.Registrar(Fase::Lectura, t_lectura.stop(), 0);
 
-    std::vector<int> displacements(size, 0);
-    size_t total_decompressed_size = 0;
-    std::vector<uint8_t> global_decompressed_output;
+        Timer t_codificacion;
+        for (size_t k = 0; k < lote.size(); ++k) salidas[k].resize(lote[k].longitud_original);
+        pool.Ejecutar(lote.size(), [&](size_t k) {
+            correcto[k] = Descomprimir_Bloque(lote[k], cargas[k].data(), salidas[k].data(), cabecera.codec, verificar);
+        });
+        metricas.Registrar(Fase::Codificacion, t_codificacion.stop(), 0);
 
-    if (rank == 0) {
-        for (int i = 0; i < size; ++i) {
-            displacements[i] = (i > 0) ? (displacements[i-1] + global_lengths[i-1]) : 0;
-            total_decompressed_size += global_lengths[i];
+        Timer t_escritura;
+        uint64_t escritos = 0;
+        for (size_t k = 0; k < lote.size(); ++k) {
+            if (!correcto[k]) {
+                cerr << "ERROR: Bloque " << num_bloques + k << " corrupto en el archivo comprimido: " << input_file << endl;
+                Cerrar_Entrada_Flujo(fd);
+                Descartar_Salida(output_file, ofs, salida_directa, os);
+                return false;
+            }
+            os.write((const char*)salidas[k].data(), salidas[k].size());
+            escritos += salidas[k].size();
         }
-        global_decompressed_output.resize(total_decompressed_size);
+        if (!lote.empty()) os.flush();
+        num_bloques += lote.size();
+        total += escritos;
+        metricas.Registrar(Fase::Escritura, t_escritura.stop(), escritos);
     }
-    
-    MPI_Gatherv(
-        local_decompressed_output.data(), local_len, MPI_UNSIGNED_CHAR,
-        global_decompressed_output.data(), global_lengths.data(), displacements.data(), 
-        MPI_UNSIGNED_CHAR, 0, MPI_COMM_WORLD
-    );
 
-    if (rank == 0) {
-        double elapsed = t.stop();
-        std::cout << "\n--- Resultado de Descompresión Paralela (" << size << " P) ---" << std::endl;
-        std::cout << "Tiempo: " << std::fixed << std::setprecision(4) << elapsed << " s" << std::endl;
-        std::cout << "Tamaño Comprimido: " << compressed_file_size << " B" << std::endl;
-        std::cout << "Tamaño Descomprimido: " << total_decompressed_size << " B" << std::endl;
+    // El índice repite lo que ya dieron los registros: basta con que el pie coincida con lo leído
+    vector<uint8_t> cola(num_bloques * RLEContainer::TAMANO_ENTRADA_INDICE + RLEContainer::TAMANO_PIE);
+    bool cola_valida = Leer_Flujo_Exacto(fd, cola.data(), cola.size());
+    Cerrar_Entrada_Flujo(fd);
+    uint64_t offset_indice = 0, bloques_pie = 0;
+    cola_valida = cola_valida &&
+                  RLEContainer::Parsear_Pie(cola.data() + cola.size() - RLEContainer::TAMANO_PIE, leidos + cola.size(), offset_indice, bloques_pie) &&
+                  offset_indice == leidos && bloques_pie == num_bloques;
+    if (!(cabecera.banderas & RLEContainer::BANDERA_TAMANO_EN_INDICE)) {
+        cola_valida = cola_valida && total == cabecera.tamano_original;
+    }
+    bool escrito = Cerrar_Salida_Flujo(output_file, ofs, salida_directa, os);
+    if (!cola_valida || !escrito) {
+        if (!cola_valida) cerr << "ERROR: El índice o el pie no coinciden con los bloques leídos: " << input_file << endl;
+        if (!escrito) cerr << "ERROR: Falló la escritura del archivo de salida: " << output_file << endl;
+        if (output_file != "-") remove(output_file.c_str());
+        return false;
+    }
 
-        std::ofstream ofs(output_file, std::ios::binary);
-        if (ofs.is_open()) {
-            ofs.write((const char*)global_decompressed_output.data(), total_decompressed_size);
-            ofs.close();
-        } else {
-            std::cerr << "P0: ERROR al abrir el archivo de salida para escritura: " << output_file << std::endl;
-        }
+    double elapsed = t.stop();
+    metricas.Registrar(Fase::Total, elapsed, total);
+    cerr << "--- Resultado de Descompresión por Flujo ---" << endl;
+    cerr << "Tiempo: " << fixed << setprecision(4) << elapsed << " s" << endl;
+    cerr << "Tamaño Comprimido: " << leidos + cola.size() << " B" << endl;
+    cerr << "Tamaño Descomprimido: " << total << " B" << endl;
+    if (verificar) cerr << "Verificación CRC32C: " << num_bloques << " bloques correctos" << endl;
+    if (!opciones.metricas.empty()) {
+        metricas.Reducir_Y_Escribir(opciones.metricas, "descompresion", "flujo", pool.Hilos(), MPI_COMM_SELF);
     }
+    return true;
 }
 
-void RLECompressor::RunSequentialDecompress(const std::string& input_file, const std::string& output_file) {
-    Timer t;
+// Lee `longitud` bytes en `offset` de un archivo abierto. Retorna false si no hay tantos bytes.
+static bool Leer_En(ifstream& is, uint64_t offset, uint8_t* destino, size_t longitud) {
+    is.seekg(offset, ios::beg);
+    is.read((char*)destino, longitud);
+    return (bool)is;
+}
+
+bool RLECompressor::Descomprimir_Rango(const std::string& input_file, uint64_t offset, uint64_t longitud, std::vector<uint8_t>& salida, bool verificar, int hilos) {
+    salida.clear();
     ifstream is(input_file, ios::binary | ios::ate);
     if (!is.is_open()) {
         cerr << "ERROR: No se pudo abrir el archivo comprimido: " << input_file << endl;
-        return;
+        return false;
     }
+    uint64_t tamano = is.tellg();
 
-    size_t size = is.tellg();
-    is.seekg(0, ios::beg);
+    // Cabecera, pie e índice: lo único que se lee además de los bloques del rango
+    RLEContainer::Cabecera cabecera;
+    vector<RLEContainer::Bloque> bloques;
+    uint8_t buffer_cabecera[RLEContainer::TAMANO_CABECERA];
+    uint8_t buffer_pie[RLEContainer::TAMANO_PIE];
+    uint64_t offset_indice = 0, num_bloques = 0;
+    bool valido = tamano >= RLEContainer::TAMANO_CABECERA + RLEContainer::TAMANO_REGISTRO + RLEContainer::TAMANO_PIE &&
+                  Leer_En(is, 0, buffer_cabecera, RLEContainer::TAMANO_CABECERA) &&
+                  RLEContainer::Parsear_Cabecera(buffer_cabecera, cabecera) &&
+                  Leer_En(is, tamano - RLEContainer::TAMANO_PIE, buffer_pie, RLEContainer::TAMANO_PIE) &&
+                  RLEContainer::Parsear_Pie(buffer_pie, tamano, offset_indice, num_bloques);
+    if (valido) {
+        vector<uint8_t> indice(num_bloques * RLEContainer::TAMANO_ENTRADA_INDICE);
+        valido = Leer_En(is, offset_indice, indice.data(), indice.size()) &&
+                 RLEContainer::Parsear_Indice(indice.data(), num_bloques, offset_indice, bloques);
+    }
+    if (!valido) {
+        cerr << "ERROR: El acceso por rango requiere un archivo contenedor con índice: " << input_file << endl;
+        return false;
+    }
 
-    vector<uint8_t> buffer(size);
-    is.read((char*)buffer.data(), size);
-    is.close();
+    if (verificar && !(cabecera.banderas & RLEContainer::BANDERA_CRC32C)) {
+        cerr << "ADVERTENCIA: El archivo no tiene checksums CRC32C por bloque; se descomprime sin verificar." << endl;
+        verificar = false;
+    }
 
-    vector<uint8_t> decompressed = Descomprimir_Local(buffer);
+    // Offset descomprimido del inicio de cada bloque
+    vector<uint64_t> prefijo(bloques.size() + 1, 0);
+    for (size_t i = 0; i < bloques.size(); ++i) {
+        prefijo[i + 1] = prefijo[i] + bloques[i].longitud_original;
+    }
+    if (offset > prefijo.back()) {
+        cerr << "ERROR: El rango empieza después del final del archivo original (" << prefijo.back() << " B)." << endl;
+        return false;
+    }
+    longitud = min(longitud, prefijo.back() - offset);
+    if (longitud == 0) return true;
 
-    double elapsed = t.stop();
-    cout << "--- Resultado de Descompresión Secuencial (T1) ---" << endl;
-    cout << "Tiempo: " << fixed << setprecision(4) << elapsed << " s" << endl;
-    cout << "Tamaño Comprimido: " << size << " B" << endl;
-    cout << "Tamaño Descomprimido: " << decompressed.size() << " B" << endl;
+    // [lo, hi): último bloque que empieza en o antes de `offset` hasta el primero que empieza en o
+    // después del final del rango
+    size_t lo = upper_bound(prefijo.begin(), prefijo.end(), offset) - prefijo.begin() - 1;
+    size_t hi = lower_bound(prefijo.begin() + lo + 1, prefijo.end(), offset + longitud) - prefijo.begin();
 
-    ofstream ofs(output_file, ios::binary);
-    if (ofs.is_open()) {
-        ofs.write((const char*)decompressed.data(), decompressed.size());
-        ofs.close();
-    } else {
+    uint64_t offset_lectura = bloques[lo].offset;
+    vector<uint8_t> comprimido(bloques[hi - 1].offset + RLEContainer::TAMANO_REGISTRO + bloques[hi - 1].longitud_comprimida - offset_lectura);
+    if (!Leer_En(is, offset_lectura, comprimido.data(), comprimido.size())) {
+        cerr << "ERROR: No se pudieron leer los bloques del rango: " << input_file << endl;
+        return false;
+    }
+
+    // Los bloques se decodifican en su posición y después se descarta lo que queda fuera del rango
+    // (a lo más un bloque parcial en cada extremo)
+    salida.resize(prefijo[hi] - prefijo[lo]);
+    vector<uint8_t> correcto(hi - lo, 0);
+    PoolHilos pool(hilos);
+    pool.Ejecutar(hi - lo, [&](size_t k) {
+        size_t i = lo + k;
+        const uint8_t* registro = comprimido.data() + (bloques[i].offset - offset_lectura);
+        RLEContainer::Bloque leido = RLEContainer::Parsear_Registro(registro);
+        if (leido.longitud_comprimida != bloques[i].longitud_comprimida || leido.longitud_original != bloques[i].longitud_original) return;
+
+        correcto[k] = Descomprimir_Bloque(leido, registro + RLEContainer::TAMANO_REGISTRO, salida.data() + (prefijo[i] - prefijo[lo]), cabecera.codec, verificar);
+    });
+    for (size_t i = lo; i < hi; ++i) {
+        if (!correcto[i - lo]) {
+            cerr << "ERROR: Bloque " << i << " corrupto en el archivo comprimido: " << input_file << endl;
+            salida.clear();
+            return false;
+        }
+    }
+
+    uint64_t descartados = offset - prefijo[lo];
+    if (descartados > 0) memmove(salida.data(), salida.data() + descartados, longitud);
+    salida.resize(longitud);
+    return true;
+}
+
+bool RLECompressor::RunRangeDecompress(const std::string& input_file, const std::string& output_file, const RLEOptions& opciones) {
+    Timer t;
+    Metricas metricas;
+    Timer t_codificacion;
+    vector<uint8_t> salida;
+    if (!Descomprimir_Rango(input_file, opciones.rango_offset, opciones.rango_longitud, salida, opciones.verificar, opciones.hilos)) {
+        return false;
+    }
+    metricas.Registrar(Fase::Codificacion, t_codificacion.stop(), salida.size());
+
+    Timer t_escritura;
+    ofstream ofs;
+    SalidaDirecta salida_directa;
+    ostream os(nullptr);
+    if (!Abrir_Salida_Secuencial(output_file, opciones.salida_directa, ofs, salida_directa, os)) {
         cerr << "ERROR: No se pudo abrir el archivo de salida para escritura: " << output_file << endl;
+        return false;
+    }
+    os.write((const char*)salida.data(), salida.size());
+    if (!Cerrar_Salida_Secuencial(ofs, salida_directa, os)) {
+        cerr << "ERROR: Falló la escritura del archivo de salida: " << output_file << endl;
+        return false;
+    }
+    metricas.Registrar(Fase::Escritura, t_escritura.stop(), salida.size());
+
+    double elapsed = t.stop();
+    metricas.Registrar(Fase::Total, elapsed, salida.size());
+    cout << "--- Resultado de Descompresión por Rango ---" << endl;
+    cout << "Tiempo: " << fixed << setprecision(4) << elapsed << " s" << endl;
+    cout << "Rango: " << opciones.rango_offset << ":" << salida.size() << endl;
+    cout << "Tamaño Descomprimido: " << salida.size() << " B" << endl;
+    if (!opciones.metricas.empty()) {
+        metricas.Reducir_Y_Escribir(opciones.metricas, "descompresion", "rango", max(opciones.hilos, 1), MPI_COMM_SELF);
     }
-}
\ No newline at end of file
+    return true;
+}
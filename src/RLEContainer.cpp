@@ -0,0 +1,221 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+
+#include "../include/RLEContainer.hpp"
+#include <cstring>
+
+using namespace std;
+
+// --- FIRMAS DEL FORMATO ---
+static const uint8_t FIRMA_CABECERA[4] = {'R', 'L', 'E', 'X'};
+static const uint8_t FIRMA_PIE[4] = {'R', 'L', 'X', 'I'};
+
+// --- Enteros little-endian independientes de la plataforma ---
+static void Escribir_U16(uint8_t* p, uint16_t v) {
+    for (int k = 0; k < 2; ++k) p[k] = (uint8_t)(v >> (8 * k));
+}
+static void Escribir_U32(uint8_t* p, uint32_t v) {
+    for (int k = 0; k < 4; ++k) p[k] = (uint8_t)(v >> (8 * k));
+}
+static void Escribir_U64(uint8_t* p, uint64_t v) {
+    for (int k = 0; k < 8; ++k) p[k] = (uint8_t)(v >> (8 * k));
+}
+static uint16_t Leer_U16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+static uint32_t Leer_U32(const uint8_t* p) {
+    uint32_t v = 0;
+    for (int k = 3; k >= 0; --k) v = (v << 8) | p[k];
+    return v;
+}
+static uint64_t Leer_U64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int k = 7; k >= 0; --k) v = (v << 8) | p[k];
+    return v;
+}
+
+void RLEContainer::Serializar_Cabecera(const Cabecera& cabecera, uint8_t* destino) {
+    memset(destino, 0, TAMANO_CABECERA);
+    memcpy(destino, FIRMA_CABECERA, 4);
+    destino[4] = cabecera.version;
+    destino[5] = cabecera.codec;
+    Escribir_U16(destino + 6, cabecera.banderas);
+    Escribir_U64(destino + 8, cabecera.tamano_original);
+}
+
+bool RLEContainer::Parsear_Cabecera(const uint8_t* origen, Cabecera& cabecera) {
+    if (memcmp(origen, FIRMA_CABECERA, 4) != 0) return false;
+    if (origen[4] == 0 || origen[4] > VERSION) return false;
+    if (origen[5] > CODEC_MAXIMO) return false;
+
+    cabecera.version = origen[4];
+    cabecera.codec = origen[5];
+    cabecera.banderas = Leer_U16(origen + 6);
+    cabecera.tamano_original = Leer_U64(origen + 8);
+    return true;
+}
+
+void RLEContainer::Serializar_Registro(const Bloque& bloque, uint8_t* destino) {
+    destino[0] = bloque.tipo;
+    destino[1] = destino[2] = destino[3] = 0;
+    Escribir_U32(destino + 4, bloque.checksum);
+    Escribir_U64(destino + 8, bloque.longitud_comprimida);
+    Escribir_U64(destino + 16, bloque.longitud_original);
+}
+
+RLEContainer::Bloque RLEContainer::Parsear_Registro(const uint8_t* origen) {
+    Bloque bloque;
+    bloque.tipo = origen[0];
+    bloque.checksum = Leer_U32(origen + 4);
+    bloque.longitud_comprimida = Leer_U64(origen + 8);
+    bloque.longitud_original = Leer_U64(origen + 16);
+    return bloque;
+}
+
+uint64_t RLEContainer::Asignar_Offsets(vector<Bloque>& bloques, uint64_t inicio) {
+    uint64_t offset = inicio;
+    for (Bloque& b : bloques) {
+        b.offset = offset;
+        offset += TAMANO_REGISTRO + b.longitud_comprimida;
+    }
+    return offset;
+}
+
+vector<uint8_t> RLEContainer::Serializar_Entradas(const vector<Bloque>& bloques) {
+    vector<uint8_t> entradas(bloques.size() * TAMANO_ENTRADA_INDICE);
+    uint8_t* entrada = entradas.data();
+    for (const Bloque& b : bloques) {
+        Escribir_U64(entrada, b.offset);
+        Escribir_U64(entrada + 8, b.longitud_comprimida);
+        Escribir_U64(entrada + 16, b.longitud_original);
+        entrada += TAMANO_ENTRADA_INDICE;
+    }
+    return entradas;
+}
+
+void RLEContainer::Serializar_Pie(uint64_t offset_indice, uint64_t num_bloques, uint8_t* destino) {
+    Escribir_U64(destino, offset_indice);
+    Escribir_U64(destino + 8, num_bloques);
+    Escribir_U32(destino + 16, 0);
+    memcpy(destino + 20, FIRMA_PIE, 4);
+}
+
+vector<uint8_t> RLEContainer::Serializar_Cola(const vector<Bloque>& bloques, uint64_t offset_cola) {
+    vector<uint8_t> cola(TAMANO_REGISTRO);
+
+    Bloque fin;
+    fin.tipo = BLOQUE_FIN;
+    Serializar_Registro(fin, cola.data());
+
+    vector<uint8_t> entradas = Serializar_Entradas(bloques);
+    cola.insert(cola.end(), entradas.begin(), entradas.end());
+
+    cola.resize(cola.size() + TAMANO_PIE);
+    Serializar_Pie(offset_cola + TAMANO_REGISTRO, bloques.size(), cola.data() + cola.size() - TAMANO_PIE);
+    return cola;
+}
+
+bool RLEContainer::Parsear_Pie(const uint8_t* pie, uint64_t tamano_archivo, uint64_t& offset_indice, uint64_t& num_bloques) {
+    if (memcmp(pie + 20, FIRMA_PIE, 4) != 0) return false;
+
+    offset_indice = Leer_U64(pie);
+    num_bloques = Leer_U64(pie + 8);
+
+    if (tamano_archivo < TAMANO_CABECERA + TAMANO_REGISTRO + TAMANO_PIE) return false;
+    if (offset_indice < TAMANO_CABECERA + TAMANO_REGISTRO) return false;
+    // Se acota antes de sumar: un offset o un número de bloques enorme no debe dar la vuelta
+    if (offset_indice > tamano_archivo - TAMANO_PIE) return false;
+    if (num_bloques > (tamano_archivo - TAMANO_PIE - offset_indice) / TAMANO_ENTRADA_INDICE) return false;
+    return offset_indice + num_bloques * TAMANO_ENTRADA_INDICE + TAMANO_PIE == tamano_archivo;
+}
+
+bool RLEContainer::Parsear_Indice(const uint8_t* indice, uint64_t num_bloques, uint64_t offset_indice, vector<Bloque>& bloques) {
+    bloques.resize(num_bloques);
+    // Los bloques van seguidos desde la cabecera y terminan en el registro FIN, que precede al índice
+    uint64_t limite = offset_indice - TAMANO_REGISTRO;
+    uint64_t esperado = TAMANO_CABECERA;
+
+    for (uint64_t i = 0; i < num_bloques; ++i) {
+        const uint8_t* entrada = indice + i * TAMANO_ENTRADA_INDICE;
+        Bloque& b = bloques[i];
+        b.offset = Leer_U64(entrada);
+        b.longitud_comprimida = Leer_U64(entrada + 8);
+        b.longitud_original = Leer_U64(entrada + 16);
+
+        if (b.offset < TAMANO_CABECERA || b.offset > limite - TAMANO_REGISTRO) return false;
+        if (b.longitud_comprimida > limite - b.offset - TAMANO_REGISTRO) return false;
+        // Fuera de orden o solapados, las restas entre offsets de bloques darían la vuelta
+        if (b.offset != esperado) return false;
+        esperado = b.offset + TAMANO_REGISTRO + b.longitud_comprimida;
+    }
+    return esperado == limite;
+}
+
+bool RLEContainer::Parsear(const uint8_t* datos, size_t longitud, Cabecera& cabecera, vector<Bloque>& bloques) {
+    if (longitud < TAMANO_CABECERA + TAMANO_REGISTRO + TAMANO_PIE) return false;
+    if (!Parsear_Cabecera(datos, cabecera)) return false;
+
+    uint64_t offset_indice = 0, num_bloques = 0;
+    if (!Parsear_Pie(datos + longitud - TAMANO_PIE, longitud, offset_indice, num_bloques)) return false;
+    if (!Parsear_Indice(datos + offset_indice, num_bloques, offset_indice, bloques)) return false;
+
+    // El registro de cada bloque debe coincidir con su entrada en el índice
+    for (Bloque& b : bloques) {
+        Bloque registro = Parsear_Registro(datos + b.offset);
+        if (registro.longitud_comprimida != b.longitud_comprimida ||
+            registro.longitud_original != b.longitud_original) {
+            return false;
+        }
+        b.tipo = registro.tipo;
+        b.checksum = registro.checksum;
+    }
+    return true;
+}
+
+bool RLEContainer::Escribir_Cabecera(ostream& os, const Cabecera& cabecera) {
+    uint8_t buffer_cabecera[TAMANO_CABECERA];
+    Serializar_Cabecera(cabecera, buffer_cabecera);
+    os.write((const char*)buffer_cabecera, TAMANO_CABECERA);
+    return (bool)os;
+}
+
+bool RLEContainer::Escribir_Bloque(ostream& os, const Bloque& bloque, const uint8_t* carga) {
+    uint8_t registro[TAMANO_REGISTRO];
+    Serializar_Registro(bloque, registro);
+    os.write((const char*)registro, TAMANO_REGISTRO);
+    os.write((const char*)carga, bloque.longitud_comprimida);
+    return (bool)os;
+}
+
+bool RLEContainer::Escribir_Cola(ostream& os, vector<Bloque> bloques) {
+    // Los bloques se escribieron consecutivamente tras la cabecera
+    uint64_t offset_cola = Asignar_Offsets(bloques, TAMANO_CABECERA);
+    vector<uint8_t> cola = Serializar_Cola(bloques, offset_cola);
+    os.write((const char*)cola.data(), cola.size());
+    return (bool)os;
+}
+
+bool RLEContainer::Escribir(ostream& os, const Cabecera& cabecera, const uint8_t* carga, vector<Bloque> bloques) {
+    Escribir_Cabecera(os, cabecera);
+    for (const Bloque& b : bloques) {
+        Escribir_Bloque(os, b, carga);
+        carga += b.longitud_comprimida;
+    }
+    return Escribir_Cola(os, bloques);
+}
+
+bool RLEContainer::Extraer_Carga(const vector<uint8_t>& archivo, vector<uint8_t>& carga) {
+    Cabecera cabecera;
+    vector<Bloque> bloques;
+    if (!Parsear(archivo.data(), archivo.size(), cabecera, bloques)) return false;
+
+    carga.clear();
+    for (const Bloque& b : bloques) {
+        const uint8_t* inicio = archivo.data() + b.offset + TAMANO_REGISTRO;
+        carga.insert(carga.end(), inicio, inicio + b.longitud_comprimida);
+    }
+    return true;
+}
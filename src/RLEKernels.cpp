@@ -0,0 +1,309 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+
+#include "../include/RLEKernels.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RLE_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// --- Versiones escalares (también resuelven las colas de las vectoriales) ---
+
+static size_t Longitud_Corrida_Escalar(const uint8_t* datos, size_t longitud, uint8_t valor) {
+    size_t p = 0;
+    while (p < longitud && datos[p] == valor) p++;
+    return p;
+}
+
+// Avanza desde `p` mientras el byte no sea bandera ni inicie una corrida de 3. Los dos últimos bytes
+// no se clasifican: así toda corrida que toque el prefijo queda contenida en `datos`.
+static size_t Recorrer_Literales(const uint8_t* datos, size_t longitud, size_t p) {
+    while (p + 2 < longitud) {
+        uint8_t b = datos[p];
+        if ((b | 0x01) == 0xFF) break;
+        if (b == datos[p + 1] && b == datos[p + 2]) break;
+        p++;
+    }
+    return p;
+}
+
+static size_t Longitud_Literales_Escalar(const uint8_t* datos, size_t longitud) {
+    return Recorrer_Literales(datos, longitud, 0);
+}
+
+static size_t Longitud_Sin_Banderas_Escalar(const uint8_t* datos, size_t longitud) {
+    size_t p = 0;
+    while (p < longitud && (datos[p] | 0x01) != 0xFF) p++;
+    return p;
+}
+
+// --- CRC32C (Castagnoli), en la representación reflejada de la instrucción crc32 de SSE4.2 ---
+
+static const uint32_t POLINOMIO_CRC32C = 0x82F63B78;
+
+static uint32_t CRC32C_Escalar(const uint8_t* datos, size_t longitud, uint32_t crc) {
+    static const struct Tabla {
+        uint32_t t[256];
+        Tabla() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ POLINOMIO_CRC32C : c >> 1;
+                t[i] = c;
+            }
+        }
+    } tabla;
+    crc = ~crc;
+    for (size_t p = 0; p < longitud; ++p) crc = tabla.t[(crc ^ datos[p]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2")))
+static uint32_t CRC32C_SSE42(const uint8_t* datos, size_t longitud, uint32_t crc) {
+    uint64_t c = (uint32_t)~crc;
+    size_t p = 0;
+    for (; p + 8 <= longitud; p += 8) {
+        uint64_t v;
+        memcpy(&v, datos + p, 8);
+        c = _mm_crc32_u64(c, v);
+    }
+    uint32_t c32 = (uint32_t)c;
+    for (; p < longitud; ++p) c32 = _mm_crc32_u8(c32, datos[p]);
+    return ~c32;
+}
+#endif
+
+// a(x) * b(x) módulo el polinomio, en la representación reflejada (el bit 31 es x^0).
+static uint32_t Multiplicar_Modulo(uint32_t a, uint32_t b) {
+    uint32_t m = 1u << 31, p = 0;
+    while (true) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ POLINOMIO_CRC32C : b >> 1;
+    }
+    return p;
+}
+
+// x^(8 * n) módulo el polinomio: desplaza un CRC sobre n bytes, con potencias x^(2^k) precalculadas.
+static uint32_t Potencia_Bytes(uint64_t n) {
+    static const struct Potencias {
+        uint32_t t[64];
+        Potencias() {
+            uint32_t p = 1u << 30;  // x^1
+            for (int k = 0; k < 64; ++k) {
+                t[k] = p;
+                p = Multiplicar_Modulo(p, p);
+            }
+        }
+    } potencias;
+    uint32_t p = 1u << 31;  // x^0
+    for (int k = 3; n > 0; n >>= 1, ++k) {
+        if (n & 1) p = Multiplicar_Modulo(potencias.t[k], p);
+    }
+    return p;
+}
+
+#ifdef RLE_KERNELS_X86
+
+static size_t Longitud_Corrida_SSE2(const uint8_t* datos, size_t longitud, uint8_t valor) {
+    const __m128i patron = _mm_set1_epi8((char)valor);
+    size_t p = 0;
+    for (; p + 16 <= longitud; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(datos + p));
+        unsigned distintos = ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, patron)) & 0xFFFF;
+        if (distintos) return p + __builtin_ctz(distintos);
+    }
+    return p + Longitud_Corrida_Escalar(datos + p, longitud - p, valor);
+}
+
+static size_t Recorrer_Literales_SSE2(const uint8_t* datos, size_t longitud, size_t p) {
+    const __m128i unos = _mm_set1_epi8(0x01);
+    const __m128i banderas = _mm_set1_epi8((char)0xFF);
+    // Cada posición necesita sus dos vecinos: se clasifican 16 posiciones con tres cargas desplazadas
+    for (; p + 18 <= longitud; p += 16) {
+        __m128i v0 = _mm_loadu_si128((const __m128i*)(datos + p));
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(datos + p + 1));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(datos + p + 2));
+        __m128i triple = _mm_and_si128(_mm_cmpeq_epi8(v0, v1), _mm_cmpeq_epi8(v1, v2));
+        __m128i bandera = _mm_cmpeq_epi8(_mm_or_si128(v0, unos), banderas);
+        unsigned cortes = (unsigned)_mm_movemask_epi8(_mm_or_si128(triple, bandera));
+        if (cortes) return p + __builtin_ctz(cortes);
+    }
+    return Recorrer_Literales(datos, longitud, p);
+}
+
+static size_t Longitud_Literales_SSE2(const uint8_t* datos, size_t longitud) {
+    return Recorrer_Literales_SSE2(datos, longitud, 0);
+}
+
+static size_t Longitud_Sin_Banderas_SSE2(const uint8_t* datos, size_t longitud) {
+    const __m128i unos = _mm_set1_epi8(0x01);
+    const __m128i banderas = _mm_set1_epi8((char)0xFF);
+    size_t p = 0;
+    for (; p + 16 <= longitud; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(datos + p));
+        unsigned cortes = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(v, unos), banderas));
+        if (cortes) return p + __builtin_ctz(cortes);
+    }
+    return p + Longitud_Sin_Banderas_Escalar(datos + p, longitud - p);
+}
+
+__attribute__((target("avx2")))
+static size_t Longitud_Corrida_AVX2(const uint8_t* datos, size_t longitud, uint8_t valor) {
+    const __m256i patron = _mm256_set1_epi8((char)valor);
+    size_t p = 0;
+    for (; p + 32 <= longitud; p += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(datos + p));
+        unsigned distintos = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, patron));
+        if (distintos) return p + __builtin_ctz(distintos);
+    }
+    return p + Longitud_Corrida_SSE2(datos + p, longitud - p, valor);
+}
+
+__attribute__((target("avx2")))
+static size_t Longitud_Literales_AVX2(const uint8_t* datos, size_t longitud) {
+    const __m256i unos = _mm256_set1_epi8(0x01);
+    const __m256i banderas = _mm256_set1_epi8((char)0xFF);
+    size_t p = 0;
+    for (; p + 34 <= longitud; p += 32) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i*)(datos + p));
+        __m256i v1 = _mm256_loadu_si256((const __m256i*)(datos + p + 1));
+        __m256i v2 = _mm256_loadu_si256((const __m256i*)(datos + p + 2));
+        __m256i triple = _mm256_and_si256(_mm256_cmpeq_epi8(v0, v1), _mm256_cmpeq_epi8(v1, v2));
+        __m256i bandera = _mm256_cmpeq_epi8(_mm256_or_si256(v0, unos), banderas);
+        unsigned cortes = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(triple, bandera));
+        if (cortes) return p + __builtin_ctz(cortes);
+    }
+    // La cola (menos de 34 bytes) se resuelve con la versión de 16 bytes
+    return Recorrer_Literales_SSE2(datos, longitud, p);
+}
+
+__attribute__((target("avx2")))
+static size_t Longitud_Sin_Banderas_AVX2(const uint8_t* datos, size_t longitud) {
+    const __m256i unos = _mm256_set1_epi8(0x01);
+    const __m256i banderas = _mm256_set1_epi8((char)0xFF);
+    size_t p = 0;
+    for (; p + 32 <= longitud; p += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(datos + p));
+        unsigned cortes = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_or_si256(v, unos), banderas));
+        if (cortes) return p + __builtin_ctz(cortes);
+    }
+    return p + Longitud_Sin_Banderas_SSE2(datos + p, longitud - p);
+}
+
+#endif
+
+// --- Selección en tiempo de ejecución ---
+
+typedef size_t (*Funcion_Corrida)(const uint8_t*, size_t, uint8_t);
+typedef size_t (*Funcion_Literales)(const uint8_t*, size_t);
+typedef size_t (*Funcion_Sin_Banderas)(const uint8_t*, size_t);
+typedef uint32_t (*Funcion_CRC32C)(const uint8_t*, size_t, uint32_t);
+
+// Las versiones escalares son válidas incluso antes de la inicialización dinámica
+static Funcion_Corrida funcion_corrida = Longitud_Corrida_Escalar;
+static Funcion_Literales funcion_literales = Longitud_Literales_Escalar;
+static Funcion_Sin_Banderas funcion_sin_banderas = Longitud_Sin_Banderas_Escalar;
+static Funcion_CRC32C funcion_crc32c = CRC32C_Escalar;
+static ImplementacionSIMD implementacion_activa = ImplementacionSIMD::Escalar;
+
+// La instrucción crc32 (SSE4.2) es independiente del ancho de las búsquedas vectoriales
+static Funcion_CRC32C CRC32C_Hardware() {
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("sse4.2")) return CRC32C_SSE42;
+#endif
+    return CRC32C_Escalar;
+}
+
+static bool Asignar_Funciones(ImplementacionSIMD implementacion) {
+    switch (implementacion) {
+        case ImplementacionSIMD::Escalar:
+            funcion_corrida = Longitud_Corrida_Escalar;
+            funcion_literales = Longitud_Literales_Escalar;
+            funcion_sin_banderas = Longitud_Sin_Banderas_Escalar;
+            funcion_crc32c = CRC32C_Escalar;
+            return true;
+#ifdef RLE_KERNELS_X86
+        case ImplementacionSIMD::SSE2:
+            funcion_corrida = Longitud_Corrida_SSE2;
+            funcion_literales = Longitud_Literales_SSE2;
+            funcion_sin_banderas = Longitud_Sin_Banderas_SSE2;
+            funcion_crc32c = CRC32C_Hardware();
+            return true;
+        case ImplementacionSIMD::AVX2:
+            if (!__builtin_cpu_supports("avx2")) return false;
+            funcion_corrida = Longitud_Corrida_AVX2;
+            funcion_literales = Longitud_Literales_AVX2;
+            funcion_sin_banderas = Longitud_Sin_Banderas_AVX2;
+            funcion_crc32c = CRC32C_Hardware();
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+[[maybe_unused]] static const bool funciones_iniciales = RLEKernels::Seleccionar_Implementacion(RLEKernels::Detectar_Implementacion());
+
+ImplementacionSIMD RLEKernels::Detectar_Implementacion() {
+#ifdef RLE_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return ImplementacionSIMD::AVX2;
+    return ImplementacionSIMD::SSE2;
+#else
+    return ImplementacionSIMD::Escalar;
+#endif
+}
+
+size_t RLEKernels::Longitud_Corrida(const uint8_t* datos, size_t longitud, uint8_t valor) {
+    return funcion_corrida(datos, longitud, valor);
+}
+
+size_t RLEKernels::Longitud_Literales(const uint8_t* datos, size_t longitud) {
+    return funcion_literales(datos, longitud);
+}
+
+size_t RLEKernels::Longitud_Sin_Banderas(const uint8_t* datos, size_t longitud) {
+    return funcion_sin_banderas(datos, longitud);
+}
+
+uint32_t RLEKernels::CRC32C(const uint8_t* datos, size_t longitud, uint32_t crc) {
+    return funcion_crc32c(datos, longitud, crc);
+}
+
+uint32_t RLEKernels::CRC32C_Combinar(uint32_t crc1, uint32_t crc2, uint64_t longitud2) {
+    return Multiplicar_Modulo(Potencia_Bytes(longitud2), crc1) ^ crc2;
+}
+
+bool RLEKernels::CRC32C_Por_Hardware() {
+    return funcion_crc32c != CRC32C_Escalar;
+}
+
+ImplementacionSIMD RLEKernels::Implementacion_Activa() {
+    return implementacion_activa;
+}
+
+bool RLEKernels::Seleccionar_Implementacion(ImplementacionSIMD implementacion) {
+    if (!Asignar_Funciones(implementacion)) {
+        Asignar_Funciones(implementacion_activa);
+        return false;
+    }
+    implementacion_activa = implementacion;
+    return true;
+}
+
+const char* RLEKernels::Nombre(ImplementacionSIMD implementacion) {
+    switch (implementacion) {
+        case ImplementacionSIMD::SSE2: return "SSE2";
+        case ImplementacionSIMD::AVX2: return "AVX2";
+        default: return "Escalar";
+    }
+}
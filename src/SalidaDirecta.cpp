@@ -0,0 +1,102 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+
+#include "../include/SalidaDirecta.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+SalidaDirecta::~SalidaDirecta() {
+    Cerrar();
+}
+
+bool SalidaDirecta::Abrir(const string& ruta) {
+    Cerrar();
+    error = false;
+    escritos = 0;
+
+    void* memoria = nullptr;
+    if (posix_memalign(&memoria, ALINEACION, TAMANO_BUFFER) != 0) return false;
+    buffer = (uint8_t*)memoria;
+
+#ifdef O_DIRECT
+    fd = open(ruta.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    directa = (fd >= 0);
+#endif
+    // Sistemas de archivos sin O_DIRECT (p. ej. tmpfs) rechazan la apertura con EINVAL
+    if (fd < 0) fd = open(ruta.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        free(buffer);
+        buffer = nullptr;
+        return false;
+    }
+
+    setp((char*)buffer, (char*)buffer + TAMANO_BUFFER);
+    return true;
+}
+
+bool SalidaDirecta::Escribir(const uint8_t* datos, size_t longitud) {
+    size_t hecho = 0;
+    while (hecho < longitud) {
+        ssize_t n = write(fd, datos + hecho, longitud - hecho);
+        if (n < 0 && errno == EINTR) continue;
+#ifdef O_DIRECT
+        if (n < 0 && errno == EINVAL && directa) {
+            // El dispositivo exige otra alineación: se continúa sin O_DIRECT
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+            directa = false;
+            continue;
+        }
+#endif
+        if (n <= 0) return false;
+        hecho += (size_t)n;
+    }
+    return true;
+}
+
+SalidaDirecta::int_type SalidaDirecta::overflow(int_type c) {
+    if (fd < 0) return traits_type::eof();
+
+    // El buffer lleno es múltiplo de la alineación y empieza alineado
+    size_t pendientes = pptr() - pbase();
+    if (!Escribir(buffer, pendientes)) {
+        error = true;
+        return traits_type::eof();
+    }
+    escritos += pendientes;
+    setp((char*)buffer, (char*)buffer + TAMANO_BUFFER);
+
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+bool SalidaDirecta::Cerrar() {
+    if (fd < 0) return !error;
+
+    size_t pendientes = pptr() - pbase();
+    if (pendientes > 0) {
+        // O_DIRECT solo acepta longitudes alineadas: se rellena con ceros y luego se trunca
+        size_t alineados = directa ? (pendientes + ALINEACION - 1) / ALINEACION * ALINEACION : pendientes;
+        memset(buffer + pendientes, 0, alineados - pendientes);
+        if (!Escribir(buffer, alineados)) error = true;
+        escritos += pendientes;
+    }
+    if (ftruncate(fd, (off_t)escritos) != 0) error = true;
+    if (close(fd) != 0) error = true;
+
+    fd = -1;
+    free(buffer);
+    buffer = nullptr;
+    setp(nullptr, nullptr);
+    return !error;
+}
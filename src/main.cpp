@@ -7,12 +7,14 @@
 #include "../include/RLECompressor.hpp"
 #include <iostream>
 #include <string>
+#include <cstdlib>
+#include <algorithm>
 #include <mpi.h>
 
 using namespace std;
 
 void show_usage(const string& name) {
-    cerr << "Uso: " << name << " <archivo_entrada> [OPCIONES]" << endl
+    cerr << "Uso: " << name << " <archivo_entrada|-> [OPCIONES]" << endl
          << "Opciones de Operación (mutuamente excluyentes):" << endl
          << "  --compress    (Predeterminado) Comprime el archivo." << endl
          << "  --decompress  Descomprime el archivo. El archivo de entrada debe ser el comprimido." << endl
@@ -21,11 +23,42 @@ void show_usage(const string& name) {
          << "  --secuencial  Ejecuta la versión secuencial (solo rank 0)." << endl
          << "  --parallel    Ejecuta la versión paralela (predeterminado)." << endl
          << "  --output <file> Especifica el nombre del archivo de salida." << endl
+         << "  -             Como entrada o en --output: lee de stdin o escribe en stdout por flujo" << endl
+         << "                (solo rank 0, buffers acotados; los mensajes van a stderr). Con entrada" << endl
+         << "                \"-\" la salida predeterminada es stdout." << endl
+         << "  --gather      Recolecta la salida paralela en rank 0 (MPI_Gatherv) en lugar de" << endl
+         << "                la escritura colectiva con MPI-IO (para comparación)." << endl
+         << "  --window <MiB> Tamaño de las ventanas de lectura/compresión por flujo (16 por omisión)." << endl
+         << "  --threads <N> Hilos de trabajo por proceso (1 por omisión)." << endl
+         << "  --mmap        (Secuencial) Lee la entrada proyectada en memoria (mmap) en lugar de copiarla." << endl
+         << "  --direct      (Secuencial) Escribe la salida con O_DIRECT, sin pasar por la caché de páginas." << endl
+         << "  --balance     (Paralelo) Reparte el archivo según el costo estimado de cada región" << endl
+         << "                en lugar de en tramos de igual tamaño." << endl
+         << "  --dynamic     (Paralelo) Corta el archivo en trozos pequeños que los procesos reclaman" << endl
+         << "                bajo demanda (contador compartido MPI_Fetch_and_op); siempre escritura colectiva." << endl
+         << "  --chunk <MiB> Tamaño de los trozos de --dynamic (8 por omisión)." << endl
+         << "  --codec <rle|varint|literal> Códec de la carga: conteos de 1 byte (rle, predeterminado)," << endl
+         << "                LEB128 (varint), con el que cada corrida es una sola tupla, o varint con" << endl
+         << "                bloques de literales sin escapes (literal, para datos poco compresibles)." << endl
+         << "                Se registra en la cabecera y la descompresión lo detecta." << endl
+         << "  --element-size <N> Corridas de elementos de N bytes (1-255; p. ej. 4 para enteros de 32 bits)." << endl
+         << "                Implica el códec por elementos (no se combina con --codec); los tramos y" << endl
+         << "                ventanas se alinean a N bytes." << endl
+         << "  --transpose   Con el códec por elementos, prueba también cada grupo transpuesto a planos" << endl
+         << "                de bytes (byte k de cada elemento seguido) y se queda con lo que ocupe menos." << endl
+         << "  --range <offset>:<longitud> Descomprime solo esos bytes del original (implica --decompress)." << endl
+         << "                Usa el índice del contenedor para leer únicamente los bloques del rango." << endl
+         << "  --verify      (Descompresión) Comprueba el CRC32C de cada bloque al decodificarlo y aborta" << endl
+         << "                si alguno no coincide (el archivo se comprime siempre con checksums)." << endl
+         << "  --metrics <file> Escribe los tiempos por fase (lectura, codificación, fronteras, escritura)" << endl
+         << "                reducidos entre procesos en JSON (extensión .json) o CSV." << endl
          << endl;
 }
 
 int main(int argc, char* argv[]) {
-    MPI_Init(&argc, &argv);
+    // Los hilos de trabajo no llaman a MPI: basta con que solo el hilo principal lo haga
+    int nivel_hilos = MPI_THREAD_SINGLE;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &nivel_hilos);
 
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -41,6 +74,8 @@ int main(int argc, char* argv[]) {
     string output_file;
     bool sequential_mode = false;
     bool decompress_mode = false;
+    RLEOptions opciones;
+    string codec_pedido;
 
     for (int i = 2; i < argc; ++i) {
         string arg = argv[i];
@@ -52,13 +87,94 @@ int main(int argc, char* argv[]) {
             decompress_mode = false;
         } else if (arg == "--decompress") {
             decompress_mode = true;
+        } else if (arg == "--gather") {
+            opciones.escritura = ModoEscritura::Gather;
+        } else if (arg == "--window" && i + 1 < argc) {
+            opciones.ventana = (size_t)max(1L, atol(argv[++i])) << 20;
+        } else if (arg == "--mmap") {
+            opciones.entrada_mapeada = true;
+        } else if (arg == "--direct") {
+            opciones.salida_directa = true;
+        } else if (arg == "--balance") {
+            opciones.balanceo = true;
+        } else if (arg == "--dynamic") {
+            opciones.dinamico = true;
+        } else if (arg == "--chunk" && i + 1 < argc) {
+            opciones.trozo_dinamico = (size_t)max(1L, atol(argv[++i])) << 20;
+        } else if (arg == "--codec" && i + 1 < argc) {
+            string codec = argv[++i];
+            codec_pedido = codec;
+            if (codec == "rle") {
+                opciones.codec = RLEContainer::CODEC_RLE;
+            } else if (codec == "varint") {
+                opciones.codec = RLEContainer::CODEC_RLE_VARINT;
+            } else if (codec == "literal") {
+                opciones.codec = RLEContainer::CODEC_RLE_LITERALES;
+            } else {
+                if (rank == 0) cerr << "ERROR: Códec desconocido: " << codec << endl;
+                MPI_Finalize();
+                return 1;
+            }
+        } else if (arg == "--element-size" && i + 1 < argc) {
+            long elemento = atol(argv[++i]);
+            if (elemento < 1 || elemento > 255) {
+                if (rank == 0) cerr << "ERROR: Tamaño de elemento fuera de rango (1-255): " << argv[i] << endl;
+                MPI_Finalize();
+                return 1;
+            }
+            opciones.elemento = (size_t)elemento;
+        } else if (arg == "--transpose") {
+            opciones.planos = true;
+        } else if (arg == "--range" && i + 1 < argc) {
+            string rango = argv[++i];
+            size_t separador = rango.find(':');
+            char* fin_offset = nullptr;
+            char* fin_longitud = nullptr;
+            if (separador != string::npos) {
+                opciones.rango_offset = strtoull(rango.c_str(), &fin_offset, 10);
+                opciones.rango_longitud = strtoull(rango.c_str() + separador + 1, &fin_longitud, 10);
+            }
+            if (separador == string::npos || separador == 0 || fin_offset != rango.c_str() + separador ||
+                separador + 1 == rango.size() || *fin_longitud != '\0') {
+                if (rank == 0) cerr << "ERROR: Rango inválido (se espera <offset>:<longitud> en bytes): " << rango << endl;
+                MPI_Finalize();
+                return 1;
+            }
+            opciones.rango = true;
+            decompress_mode = true;
+        } else if (arg == "--verify") {
+            opciones.verificar = true;
+        } else if (arg == "--metrics" && i + 1 < argc) {
+            opciones.metricas = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            opciones.hilos = max(1, atoi(argv[++i]));
         } else if (arg == "--output" && i + 1 < argc) {
             output_file = argv[++i];
         }
     }
     
+    // Los elementos de varios bytes y los planos solo existen en el códec por elementos
+    if (opciones.elemento > 1 || opciones.planos) {
+        if (!codec_pedido.empty()) {
+            if (rank == 0) cerr << "ERROR: --element-size/--transpose usan el códec por elementos y no admiten --codec " << codec_pedido << endl;
+            MPI_Finalize();
+            return 1;
+        }
+        opciones.codec = RLEContainer::CODEC_RLE_ELEMENTOS;
+    }
+
+    if (opciones.hilos > 1 && nivel_hilos < MPI_THREAD_FUNNELED) {
+        if (rank == 0) cerr << "ADVERTENCIA: MPI no soporta MPI_THREAD_FUNNELED; se usa 1 hilo por proceso." << endl;
+        opciones.hilos = 1;
+    }
+
     if (output_file.empty()) {
-        if (decompress_mode) {
+        if (input_file == "-") {
+            output_file = "-";
+        } else if (opciones.rango) {
+            // No se reemplaza el original por un fragmento
+            output_file = input_file + ".range";
+        } else if (decompress_mode) {
             size_t pos = input_file.find(".rle");
             if (pos != string::npos && pos == input_file.length() - 4) {
                  output_file = input_file.substr(0, pos);
@@ -70,32 +186,59 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    if (decompress_mode) {
+    // Con stdin o stdout la compresión y la descompresión van por flujo en el rank 0
+    bool flujo = (input_file == "-" || output_file == "-");
+    if (flujo && opciones.rango) {
+        if (rank == 0) cerr << "ERROR: --range necesita el índice del archivo y no admite \"-\"." << endl;
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Solo el rank que detecta el fallo devuelve false; mpirun propaga su código de salida
+    bool correcto = true;
+    if (flujo) {
+        if (rank == 0) {
+            if (size > 1) cerr << "ADVERTENCIA: El modo por flujo se ejecuta solo en el rank 0." << endl;
+            if (decompress_mode) {
+                cerr << "  - Ejecutando: Descompresion RLE Extendido por Flujo" << endl;
+                correcto = RLECompressor::RunStreamDecompress(input_file, output_file, opciones);
+            } else {
+                cerr << "  - Ejecutando: Compresion RLE Extendido por Flujo" << endl;
+                correcto = RLECompressor::RunStreamCompress(input_file, output_file, opciones);
+            }
+        }
+    } else if (decompress_mode && opciones.rango) {
+        // Un rango ocupa pocos bloques: lo descomprime el rank 0 (con sus hilos)
+        if (rank == 0) {
+            cout << "  - Ejecutando: Descompresion RLE Extendido por Rango" << endl;
+            correcto = RLECompressor::RunRangeDecompress(input_file, output_file, opciones);
+        }
+    } else if (decompress_mode) {
         if (sequential_mode) {
             if (rank == 0) {
                 cout << "  - Ejecutando: Descompresion RLE Extendido Secuencial" << endl;
-                RLECompressor::RunSequentialDecompress(input_file, output_file);
+                correcto = RLECompressor::RunSequentialDecompress(input_file, output_file, opciones);
             }
         } else {
             if (rank == 0) {
                 cout << "  - Ejecutando: Descompresion RLE Extendido Paralelo" << endl;
             }
-            RLECompressor::RunParallelDecompress(input_file, output_file, rank, size);
+            correcto = RLECompressor::RunParallelDecompress(input_file, output_file, rank, size, opciones);
         }
     } else {
         if (sequential_mode) {
             if (rank == 0) {
                 cout << "  - Ejecutando: Compresion RLE Extendido Secuencial" << endl;
-                RLECompressor::RunSequential(input_file, output_file);
+                correcto = RLECompressor::RunSequential(input_file, output_file, opciones);
             }
         } else {
             if (rank == 0) {
                 cout << "  - Ejecutando: Compresion RLE Extendido Paralelo" << endl;
             }
-            RLECompressor::RunParallel(input_file, output_file, rank, size);
+            correcto = RLECompressor::RunParallel(input_file, output_file, rank, size, opciones);
         }
     }
 
     MPI_Finalize();
-    return 0;
+    return correcto ? 0 : 1;
 }
\ No newline at end of file
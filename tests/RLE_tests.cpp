@@ -5,11 +5,14 @@
  */
 
 #include "../include/RLECompressor.hpp"
+#include "../include/RLEKernels.hpp"
+#include "../include/PoolHilos.hpp"
 #include <iostream>
 #include <vector>
 #include <cassert>
 #include <cstring>
 #include <cstdint>
+#include <algorithm>
 
 using namespace std;
 
@@ -79,12 +82,510 @@ void test_inversion_completa() {
     cout << "  - PASÓ: Inversion Completa" << endl;
 }
 
+void test_compresion_por_ventanas() {
+    cout << "  - Ejecutando: Compresion por ventanas (corridas que cruzan ventanas)" << endl;
+
+    // Corridas de 1, 2, 3, 255, 256 y 600 bytes con bytes bandera: cruzan cualquier frontera de ventana
+    vector<uint8_t> input;
+    const uint8_t valores[] = {65, FLAG_RLE, 66, FLAG_LITERAL, 67, 68};
+    const size_t corridas[] = {1, 2, 3, 255, 256, 600};
+    for (int r = 0; r < 3; ++r) {
+        for (int k = 0; k < 6; ++k) input.insert(input.end(), corridas[(k + r) % 6], valores[k]);
+    }
+    vector<uint8_t> expected = Comprimir_Local_Test(input);
+
+    for (size_t ventana : {1, 2, 3, 7, 254, 255, 256, 1000}) {
+        vector<uint8_t> actual;
+        RLECompressor::Corrida corrida;
+        for (size_t i = 0; i < input.size(); i += ventana) {
+            RLECompressor::Comprimir_Ventana(input.data() + i, min(ventana, input.size() - i), corrida, actual);
+        }
+        RLECompressor::Cerrar_Corrida(corrida, actual);
+        assert(compare_buffers(actual, expected) && "Fallo: La compresion por ventanas difiere de Comprimir_Local.");
+
+        // La frontera acumulada por ventanas coincide con la del tramo completo
+        RLECompressor::Frontera frontera;
+        for (size_t i = 0; i < input.size(); i += ventana) {
+            RLECompressor::Actualizar_Frontera(frontera, input.data() + i, min(ventana, input.size() - i));
+        }
+        assert(frontera.longitud == input.size());
+        assert(frontera.primer_byte == input.front() && frontera.ultimo_byte == input.back());
+        assert(frontera.corrida_inicial == 1);
+        size_t final_esperado = 1;
+        while (final_esperado < input.size() && input[input.size() - 1 - final_esperado] == input.back()) final_esperado++;
+        assert(frontera.corrida_final == final_esperado);
+    }
+
+    // Corridas inicial y final que cruzan ventanas, sin límite de 255
+    vector<uint8_t> larga(300, 90);
+    larga.insert(larga.end(), 2, 91);
+    larga.insert(larga.end(), 400, 92);
+    for (size_t ventana : {1, 7, 300, 301, 1000}) {
+        RLECompressor::Frontera frontera;
+        for (size_t i = 0; i < larga.size(); i += ventana) {
+            RLECompressor::Actualizar_Frontera(frontera, larga.data() + i, min(ventana, larga.size() - i));
+        }
+        assert(frontera.corrida_inicial == 300);
+        assert(frontera.corrida_final == 400);
+    }
+
+    cout << "  - PASÓ: Compresion por ventanas" << endl;
+}
+
+// Codificador byte a byte de referencia (algoritmo original, sin núcleos vectoriales)
+vector<uint8_t> comprimir_referencia(const vector<uint8_t>& buffer) {
+    vector<uint8_t> salida;
+    size_t i = 0;
+    while (i < buffer.size()) {
+        uint8_t valor_actual = buffer[i];
+        size_t j = i;
+        while (j < buffer.size() && buffer[j] == valor_actual && (j - i) < 255) j++;
+        size_t conteo = j - i;
+
+        if (conteo >= 3) {
+            salida.push_back(FLAG_RLE);
+            salida.push_back((uint8_t)conteo);
+            salida.push_back(valor_actual);
+        } else {
+            for (size_t k = 0; k < conteo; ++k) {
+                if (valor_actual == FLAG_RLE || valor_actual == FLAG_LITERAL) salida.push_back(FLAG_LITERAL);
+                salida.push_back(valor_actual);
+            }
+        }
+        i += conteo;
+    }
+    return salida;
+}
+
+// Datos aleatorios: literales, pares, corridas cortas y largas, y bytes bandera con distinta densidad
+vector<uint8_t> datos_aleatorios(uint32_t& semilla, size_t longitud) {
+    auto siguiente = [&semilla]() {
+        semilla = semilla * 1103515245 + 12345;
+        return semilla >> 8;
+    };
+    uint32_t alfabeto = 2 + siguiente() % 255;
+    uint32_t prob_corrida = siguiente() % 100;
+
+    vector<uint8_t> datos;
+    while (datos.size() < longitud) {
+        uint8_t valor = (siguiente() % 8 == 0) ? (uint8_t)(0xFE + siguiente() % 2) : (uint8_t)(siguiente() % alfabeto);
+        size_t corrida = 1;
+        if (siguiente() % 100 < prob_corrida) {
+            corrida = (siguiente() % 4 == 0) ? 1 + siguiente() % 700 : 1 + siguiente() % 4;
+        }
+        for (size_t k = 0; k < corrida && datos.size() < longitud; ++k) datos.push_back(valor);
+    }
+    return datos;
+}
+
+void test_diferencial_aleatorio() {
+    cout << "  - Ejecutando: Prueba diferencial aleatoria (Escalar/SSE2/AVX2 vs referencia, ida y vuelta)" << endl;
+
+    ImplementacionSIMD original = RLEKernels::Implementacion_Activa();
+    for (ImplementacionSIMD implementacion : {ImplementacionSIMD::Escalar, ImplementacionSIMD::SSE2, ImplementacionSIMD::AVX2}) {
+        if (!RLEKernels::Seleccionar_Implementacion(implementacion)) {
+            cout << "    (" << RLEKernels::Nombre(implementacion) << " no soportada, se omite)" << endl;
+            continue;
+        }
+
+        uint32_t semilla = 2024;
+        for (int caso = 0; caso < 2000; ++caso) {
+            size_t longitud = (caso % 10 == 0) ? semilla % 20000 : semilla % 300;
+            vector<uint8_t> input = datos_aleatorios(semilla, longitud);
+
+            vector<uint8_t> esperado = comprimir_referencia(input);
+            assert(compare_buffers(Comprimir_Local_Test(input), esperado) && "Fallo: El codificador vectorial difiere de la referencia.");
+            assert(compare_buffers(Descomprimir_Local_Test(esperado), input) && "Fallo: El decodificador vectorial no reproduce la entrada.");
+
+            // Mismo resultado con ventanas arbitrarias. Cada ventana se copia a un buffer cuyo relleno
+            // rompe las corridas: el núcleo no debe mirar más allá de la longitud indicada.
+            size_t ventana = 1 + semilla % 97;
+            vector<uint8_t> por_ventanas;
+            RLECompressor::Corrida corrida;
+            for (size_t i = 0; i < input.size(); i += ventana) {
+                size_t n = min(ventana, input.size() - i);
+                vector<uint8_t> copia(input.begin() + i, input.begin() + i + n);
+                copia.resize(n + 64, (uint8_t)(copia.back() ^ 0x01));
+                RLECompressor::Comprimir_Ventana(copia.data(), n, corrida, por_ventanas);
+            }
+            RLECompressor::Cerrar_Corrida(corrida, por_ventanas);
+            assert(compare_buffers(por_ventanas, esperado) && "Fallo: El codificador por ventanas difiere de la referencia.");
+        }
+        cout << "    " << RLEKernels::Nombre(implementacion) << ": OK" << endl;
+    }
+    RLEKernels::Seleccionar_Implementacion(original);
+
+    cout << "  - PASÓ: Prueba diferencial aleatoria" << endl;
+}
+
+void test_api_sobre_buffers() {
+    cout << "  - Ejecutando: API sobre buffers del llamador (MaxCompressedSize, Longitud_Descomprimida)" << endl;
+
+    // Peor caso: banderas aisladas, cada una ocupa 2 bytes
+    vector<uint8_t> peor;
+    for (int k = 0; k < 1000; ++k) peor.push_back((k % 2) ? FLAG_RLE : FLAG_LITERAL);
+    vector<uint8_t> salida(RLECompressor::MaxCompressedSize(peor.size()));
+    size_t escritos = RLECompressor::Comprimir_Local(peor.data(), peor.size(), salida.data(), salida.size());
+    assert(escritos == RLECompressor::MaxCompressedSize(peor.size()) && "Fallo: El peor caso no alcanza la cota.");
+
+    // Sin capacidad suficiente no se escribe nada
+    escritos = RLECompressor::Comprimir_Local(peor.data(), peor.size(), salida.data(), salida.size() - 1);
+    assert(escritos == RLECompressor::SIN_CAPACIDAD);
+
+    // Buffer reutilizado para varias entradas y comparación con la API de vectores
+    uint32_t semilla = 77;
+    vector<uint8_t> comprimido(RLECompressor::MaxCompressedSize(20000));
+    vector<uint8_t> descomprimido(20000);
+    for (int caso = 0; caso < 200; ++caso) {
+        vector<uint8_t> input = datos_aleatorios(semilla, semilla % 20000);
+        size_t n = RLECompressor::Comprimir_Local(input.data(), input.size(), comprimido.data(), comprimido.size());
+        assert(n <= RLECompressor::MaxCompressedSize(input.size()));
+        assert(compare_buffers(vector<uint8_t>(comprimido.begin(), comprimido.begin() + n), comprimir_referencia(input)));
+
+        assert(RLECompressor::Longitud_Descomprimida(comprimido.data(), n) == input.size());
+        size_t m = RLECompressor::Descomprimir_Local(comprimido.data(), n, descomprimido.data(), input.size());
+        assert(m == input.size() && memcmp(descomprimido.data(), input.data(), m) == 0);
+
+        // Un byte menos de capacidad se detecta
+        if (!input.empty()) {
+            m = RLECompressor::Descomprimir_Local(comprimido.data(), n, descomprimido.data(), input.size() - 1);
+            assert(m == RLECompressor::SIN_CAPACIDAD && "Fallo: No se detectó la falta de capacidad.");
+        }
+    }
+
+    // Un token truncado al final no produce bytes, igual que Descomprimir_Local
+    vector<uint8_t> truncado = {65, FLAG_RLE, 10};
+    assert(RLECompressor::Longitud_Descomprimida(truncado.data(), truncado.size()) == 1);
+    assert(Descomprimir_Local_Test(truncado).size() == 1);
+
+    cout << "  - PASÓ: API sobre buffers del llamador" << endl;
+}
+
+void test_compresion_con_hilos() {
+    cout << "  - Ejecutando: Compresion por partes con hilos (corridas que cruzan partes)" << endl;
+
+    // Corridas largas que cubren partes completas y que terminan justo antes o después de un corte,
+    // intercaladas con datos aleatorios y corridas de bytes bandera
+    uint32_t semilla = 2024;
+    vector<uint8_t> input = datos_aleatorios(semilla, 200000);
+    input.insert(input.end(), 300000, FLAG_RLE);
+    vector<uint8_t> medio = datos_aleatorios(semilla, 100000);
+    input.insert(input.end(), medio.begin(), medio.end());
+    input.insert(input.end(), 70000, 'A');
+    input.insert(input.end(), 70000, 'B');
+    input.insert(input.end(), 2, FLAG_LITERAL);
+    medio = datos_aleatorios(semilla, 300001);
+    input.insert(input.end(), medio.begin(), medio.end());
+    vector<uint8_t> expected = Comprimir_Local_Test(input);
+
+    for (int hilos : {2, 3, 4, 7}) {
+        PoolHilos pool(hilos);
+        vector<vector<uint8_t>> parciales;
+
+        for (size_t ventana : {input.size(), (size_t)400000, (size_t)131072 + 1}) {
+            vector<uint8_t> actual;
+            RLECompressor::Corrida corrida;
+            for (size_t i = 0; i < input.size(); i += ventana) {
+                RLECompressor::Comprimir_Ventana_Paralela(pool, input.data() + i, min(ventana, input.size() - i), corrida, actual, parciales);
+            }
+            RLECompressor::Cerrar_Corrida(corrida, actual);
+            assert(compare_buffers(actual, expected) && "Fallo: La compresion con hilos difiere de Comprimir_Local.");
+        }
+    }
+
+    // Agregar_Corrida parte las corridas en tuplas de 255 igual que Comprimir_Local
+    vector<uint8_t> actual;
+    RLECompressor::Corrida corrida;
+    RLECompressor::Agregar_Corrida(corrida, 'C', 2, actual);
+    RLECompressor::Agregar_Corrida(corrida, 'C', 600, actual);
+    RLECompressor::Agregar_Corrida(corrida, FLAG_RLE, 1, actual);
+    RLECompressor::Cerrar_Corrida(corrida, actual);
+    vector<uint8_t> corridas(602, 'C');
+    corridas.push_back(FLAG_RLE);
+    assert(compare_buffers(actual, Comprimir_Local_Test(corridas)) && "Fallo: Agregar_Corrida no respeta el límite de 255.");
+
+    cout << "  - PASÓ: Compresion por partes con hilos" << endl;
+}
+
+void test_codec_varint() {
+    cout << "  - Ejecutando: Códec con conteos LEB128 (corridas largas en una tupla)" << endl;
+    const uint8_t VARINT = RLEContainer::CODEC_RLE_VARINT;
+
+    // 300 'A' = 0xAC 0x02 en LEB128; las corridas de hasta 127 coinciden con el códec clásico
+    vector<uint8_t> input(300, 'A');
+    input.push_back('B');
+    input.insert(input.end(), 100, FLAG_RLE);
+    input.insert(input.end(), 2, FLAG_LITERAL);
+    vector<uint8_t> expected = {FLAG_RLE, 0xAC, 0x02, 'A', 'B', FLAG_RLE, 100, FLAG_RLE, FLAG_LITERAL, FLAG_LITERAL, FLAG_LITERAL, FLAG_LITERAL};
+    vector<uint8_t> actual = RLECompressor::Comprimir_Local(input, VARINT);
+    assert(compare_buffers(actual, expected) && "Fallo: Tuplas LEB128 incorrectas.");
+    assert(compare_buffers(RLECompressor::Descomprimir_Local(actual, VARINT), input));
+
+    // Una corrida de 10 MiB es un solo token
+    vector<uint8_t> plana(10 << 20, 7);
+    actual = RLECompressor::Comprimir_Local(plana, VARINT);
+    assert(actual.size() == 2 + 4 && "Fallo: La corrida larga no es una sola tupla.");
+    assert(RLECompressor::Longitud_Descomprimida(actual.data(), actual.size(), VARINT) == plana.size());
+    assert(compare_buffers(RLECompressor::Descomprimir_Local(actual, VARINT), plana));
+
+    // Ida y vuelta, ventanas, hilos y Agregar_Corrida producen lo mismo que Comprimir_Local
+    uint32_t semilla = 99;
+    vector<uint8_t> mixta = datos_aleatorios(semilla, 150000);
+    mixta.insert(mixta.end(), 200000, FLAG_RLE);
+    vector<uint8_t> cola = datos_aleatorios(semilla, 150000);
+    mixta.insert(mixta.end(), cola.begin(), cola.end());
+    expected = RLECompressor::Comprimir_Local(mixta, VARINT);
+    assert(compare_buffers(RLECompressor::Descomprimir_Local(expected, VARINT), mixta));
+
+    PoolHilos pool(3);
+    vector<vector<uint8_t>> parciales;
+    for (size_t ventana : {(size_t)1000, (size_t)65537, mixta.size()}) {
+        actual.clear();
+        RLECompressor::Corrida corrida;
+        corrida.codec = VARINT;
+        for (size_t i = 0; i < mixta.size(); i += ventana) {
+            RLECompressor::Comprimir_Ventana_Paralela(pool, mixta.data() + i, min(ventana, mixta.size() - i), corrida, actual, parciales);
+        }
+        RLECompressor::Cerrar_Corrida(corrida, actual);
+        assert(compare_buffers(actual, expected) && "Fallo: La compresión por ventanas LEB128 difiere.");
+    }
+
+    actual.clear();
+    RLECompressor::Corrida corrida;
+    corrida.codec = VARINT;
+    RLECompressor::Agregar_Corrida(corrida, 'C', 2, actual);
+    RLECompressor::Agregar_Corrida(corrida, 'C', 600, actual);
+    RLECompressor::Cerrar_Corrida(corrida, actual);
+    assert(compare_buffers(actual, RLECompressor::Comprimir_Local(vector<uint8_t>(602, 'C'), VARINT)));
+
+    // Un conteo truncado no produce bytes
+    vector<uint8_t> truncado = {65, FLAG_RLE, 0x80};
+    assert(RLECompressor::Longitud_Descomprimida(truncado.data(), truncado.size(), VARINT) == 1);
+    assert(RLECompressor::Descomprimir_Local(truncado, VARINT).size() == 1);
+
+    cout << "  - PASÓ: Códec con conteos LEB128" << endl;
+}
+
+void test_codec_literales() {
+    cout << "  - Ejecutando: Códec con bloques de literales (sin escapes)" << endl;
+    const uint8_t LITERALES = RLEContainer::CODEC_RLE_LITERALES;
+
+    // Las banderas van sin escapar dentro del bloque; la corrida es una tupla LEB128
+    vector<uint8_t> input = {'A', FLAG_RLE, FLAG_LITERAL, 'B', 'B'};
+    input.insert(input.end(), 300, 'C');
+    input.push_back(FLAG_RLE);
+    vector<uint8_t> expected = {FLAG_LITERAL, 5, 'A', FLAG_RLE, FLAG_LITERAL, 'B', 'B', FLAG_RLE, 0xAC, 0x02, 'C', FLAG_LITERAL, 1, FLAG_RLE};
+    vector<uint8_t> actual = RLECompressor::Comprimir_Local(input, LITERALES);
+    assert(compare_buffers(actual, expected) && "Fallo: Bloques de literales incorrectos.");
+    assert(compare_buffers(RLECompressor::Descomprimir_Local(actual, LITERALES), input));
+
+    // Un solo byte es el peor caso (bandera, longitud y byte): la cota lo cubre
+    vector<uint8_t> uno = {FLAG_RLE};
+    actual = RLECompressor::Comprimir_Local(uno, LITERALES);
+    assert(actual.size() == RLECompressor::MaxCompressedSize(1, LITERALES));
+    assert(compare_buffers(RLECompressor::Descomprimir_Local(actual, LITERALES), uno));
+
+    // Bytes uniformes (incompresibles): sobrecosto de unos pocos bytes por bloque de MAX_BLOQUE_LITERALES
+    uint32_t semilla = 2024;
+    vector<uint8_t> aleatorios(1 << 20);
+    for (uint8_t& b : aleatorios) {
+        semilla = semilla * 1103515245 + 12345;
+        b = (uint8_t)(semilla >> 16);
+    }
+    actual = RLECompressor::Comprimir_Local(aleatorios, LITERALES);
+    assert(actual.size() < aleatorios.size() + aleatorios.size() / 1000 && "Fallo: Los literales no acotan el sobrecosto.");
+    assert(actual.size() < RLECompressor::Comprimir_Local(aleatorios).size());
+    assert(RLECompressor::Longitud_Descomprimida(actual.data(), actual.size(), LITERALES) == aleatorios.size());
+    assert(compare_buffers(RLECompressor::Descomprimir_Local(actual, LITERALES), aleatorios));
+    vector<RLEContainer::Bloque> bloques = RLECompressor::Dividir_En_Bloques(actual.data(), actual.size(), 100000, LITERALES);
+    // Los bloques de literales se parten, así que los bloques del contenedor no se pasan del objetivo
+    for (size_t k = 0; k + 1 < bloques.size(); ++k) {
+        assert(bloques[k].longitud_original >= 100000);
+        assert(bloques[k].longitud_original < 100000 + RLECompressor::MAX_BLOQUE_LITERALES);
+    }
+
+    // Por ventanas y con hilos cada tramo se codifica por separado: la salida cambia pero se decodifica igual
+    vector<uint8_t> mixta = datos_aleatorios(semilla, 150000);
+    mixta.insert(mixta.end(), 200000, FLAG_LITERAL);
+    vector<uint8_t> cola = datos_aleatorios(semilla, 150000);
+    mixta.insert(mixta.end(), cola.begin(), cola.end());
+    PoolHilos pool(3);
+    vector<vector<uint8_t>> parciales;
+    for (size_t ventana : {(size_t)1000, (size_t)65537, mixta.size()}) {
+        actual.clear();
+        RLECompressor::Corrida corrida;
+        corrida.codec = LITERALES;
+        for (size_t i = 0; i < mixta.size(); i += ventana) {
+            RLECompressor::Comprimir_Ventana_Paralela(pool, mixta.data() + i, min(ventana, mixta.size() - i), corrida, actual, parciales);
+        }
+        RLECompressor::Cerrar_Corrida(corrida, actual);
+        assert(compare_buffers(RLECompressor::Descomprimir_Local(actual, LITERALES), mixta) && "Fallo: La compresión por ventanas con literales no se decodifica.");
+    }
+
+    // Un bloque truncado o un byte fuera de bloque terminan el flujo
+    vector<uint8_t> truncado = {FLAG_RLE, 4, 'A', FLAG_LITERAL, 3, 'x', 'y'};
+    assert(RLECompressor::Longitud_Descomprimida(truncado.data(), truncado.size(), LITERALES) == 4);
+    assert(RLECompressor::Descomprimir_Local(truncado, LITERALES).size() == 4);
+    vector<uint8_t> suelto = {FLAG_LITERAL, 1, 'x', 'y'};
+    assert(RLECompressor::Longitud_Descomprimida(suelto.data(), suelto.size(), LITERALES) == 1);
+
+    cout << "  - PASÓ: Códec con bloques de literales" << endl;
+}
+
+void test_codec_elementos() {
+    cout << "  - Ejecutando: Códec por elementos de varios bytes y planos de bytes" << endl;
+    const uint8_t ELEMENTOS = RLEContainer::CODEC_RLE_ELEMENTOS;
+    const uint8_t FLAG_ELEMENTOS = 0xFD, FLAG_PLANOS = 0xFC;
+
+    // Corrida de 100 enteros de 32 bits iguales (sus bytes no forman corridas) y un byte final suelto
+    vector<uint8_t> input;
+    for (int k = 0; k < 100; ++k) input.insert(input.end(), {0x01, 0x02, 0x03, 0x04});
+    input.push_back('x');
+    vector<uint8_t> expected = {FLAG_ELEMENTOS, 4, 100, 0x01, 0x02, 0x03, 0x04, FLAG_LITERAL, 1, 'x'};
+    vector<uint8_t> actual = RLECompressor::Comprimir_Local(input, ELEMENTOS, 4);
+    assert(compare_buffers(actual, expected) && "Fallo: Tupla de elementos incorrecta.");
+    assert(compare_buffers(RLECompressor::Descomprimir_Local(actual, ELEMENTOS), input));
+    // Byte a byte no hay nada que comprimir
+    assert(RLECompressor::Comprimir_Local(input, RLEContainer::CODEC_RLE_LITERALES).size() > input.size());
+
+    // Dos elementos iguales no se emiten como tupla: no ocupan menos
+    vector<uint8_t> par = {1, 2, 1, 2};
+    vector<uint8_t> par_esperado = {FLAG_LITERAL, 4, 1, 2, 1, 2};
+    assert(compare_buffers(RLECompressor::Comprimir_Local(par, ELEMENTOS, 2), par_esperado));
+
+    // Corridas de elementos de cada ancho especializado (2, 4, 8) y de registros de 12 y 3 bytes
+    uint32_t semilla = 77;
+    for (size_t ancho : {(size_t)2, (size_t)4, (size_t)8, (size_t)12, (size_t)3}) {
+        vector<uint8_t> datos;
+        while (datos.size() < 200000) {
+            vector<uint8_t> elemento = datos_aleatorios(semilla, ancho);
+            semilla = semilla * 1103515245 + 12345;
+            size_t repeticiones = 1 + (semilla >> 16) % 9;
+            for (size_t r = 0; r < repeticiones; ++r) datos.insert(datos.end(), elemento.begin(), elemento.end());
+        }
+        datos.resize(datos.size() + 1 - ancho / 2);  // Bytes finales que no completan un elemento
+        for (bool planos : {false, true}) {
+            actual = RLECompressor::Comprimir_Local(datos, ELEMENTOS, ancho, planos);
+            assert(actual.size() < datos.size() / 2 && "Fallo: Las corridas de elementos no comprimen.");
+            assert(actual.size() <= RLECompressor::MaxCompressedSize(datos.size(), ELEMENTOS));
+            assert(RLECompressor::Longitud_Descomprimida(actual.data(), actual.size(), ELEMENTOS) == datos.size());
+            assert(compare_buffers(RLECompressor::Descomprimir_Local(actual, ELEMENTOS), datos) && "Fallo: Inversión por elementos.");
+        }
+    }
+
+    // Contadores que crecen despacio: sin corridas de elementos, pero los planos de los bytes altos
+    // son corridas largas. La transposición los comprime y se decodifica igual.
+    vector<uint8_t> contadores;
+    uint32_t valor = 0;
+    for (int k = 0; k < 200000; ++k) {
+        semilla = semilla * 1103515245 + 12345;
+        valor += (semilla >> 16) % 4;
+        for (int b = 0; b < 4; ++b) contadores.push_back((uint8_t)(valor >> (8 * b)));
+    }
+    vector<uint8_t> sin_planos = RLECompressor::Comprimir_Local(contadores, ELEMENTOS, 4);
+    vector<uint8_t> con_planos = RLECompressor::Comprimir_Local(contadores, ELEMENTOS, 4, true);
+    assert(con_planos[0] == FLAG_PLANOS);
+    assert(con_planos.size() < sin_planos.size() / 2 && "Fallo: Los planos de bytes no comprimen los contadores.");
+    assert(compare_buffers(RLECompressor::Descomprimir_Local(con_planos, ELEMENTOS), contadores));
+    vector<RLEContainer::Bloque> bloques = RLECompressor::Dividir_En_Bloques(con_planos.data(), con_planos.size(), 100000, ELEMENTOS);
+    uint64_t total = 0;
+    for (const RLEContainer::Bloque& b : bloques) total += b.longitud_original;
+    assert(bloques.size() > 1 && total == contadores.size());
+
+    // Por ventanas alineadas al elemento y con hilos: cada parte se codifica por separado
+    PoolHilos pool(3);
+    vector<vector<uint8_t>> parciales;
+    for (size_t ventana : {(size_t)1000, (size_t)65536, contadores.size()}) {
+        actual.clear();
+        RLECompressor::Corrida corrida;
+        corrida.codec = ELEMENTOS;
+        corrida.elemento = 4;
+        corrida.planos = true;
+        for (size_t i = 0; i < contadores.size(); i += ventana) {
+            RLECompressor::Comprimir_Ventana_Paralela(pool, contadores.data() + i, min(ventana, contadores.size() - i), corrida, actual, parciales);
+        }
+        RLECompressor::Cerrar_Corrida(corrida, actual);
+        assert(compare_buffers(RLECompressor::Descomprimir_Local(actual, ELEMENTOS), contadores) && "Fallo: La compresión por ventanas con elementos no se decodifica.");
+    }
+
+    // Tuplas truncadas o de ancho 0 terminan el flujo; sin CODEC_RLE_ELEMENTOS las banderas son bytes comunes
+    vector<uint8_t> truncado = {FLAG_RLE, 4, 'A', FLAG_ELEMENTOS, 4, 10, 1, 2};
+    assert(RLECompressor::Longitud_Descomprimida(truncado.data(), truncado.size(), ELEMENTOS) == 4);
+    assert(RLECompressor::Descomprimir_Local(truncado, ELEMENTOS).size() == 4);
+    vector<uint8_t> ancho_cero = {FLAG_ELEMENTOS, 0, 10, 1};
+    assert(RLECompressor::Descomprimir_Local(ancho_cero, ELEMENTOS).empty());
+    vector<uint8_t> comunes = {FLAG_ELEMENTOS, FLAG_PLANOS};
+    assert(compare_buffers(RLECompressor::Descomprimir_Local(comunes), comunes));
+
+    cout << "  - PASÓ: Códec por elementos" << endl;
+}
+
+void test_checksums_crc32c() {
+    cout << "  - Ejecutando: CRC32C por bloque (hardware/tabla, combinación, checksums desde los tokens)" << endl;
+
+    // Valor de comprobación estándar de CRC-32C (Castagnoli)
+    const char* prueba = "123456789";
+    assert(RLEKernels::CRC32C((const uint8_t*)prueba, 9) == 0xE3069283 && "Fallo: CRC32C estándar.");
+
+    // La versión por hardware (si existe) y la de tabla coinciden, también de forma incremental
+    uint32_t semilla = 4242;
+    vector<uint8_t> datos = datos_aleatorios(semilla, 100003);
+    ImplementacionSIMD original = RLEKernels::Implementacion_Activa();
+    uint32_t activo = RLEKernels::CRC32C(datos.data(), datos.size());
+    RLEKernels::Seleccionar_Implementacion(ImplementacionSIMD::Escalar);
+    assert(RLEKernels::CRC32C(datos.data(), datos.size()) == activo && "Fallo: CRC32C por hardware difiere de la tabla.");
+    RLEKernels::Seleccionar_Implementacion(original);
+    cout << "    CRC32C por hardware: " << (RLEKernels::CRC32C_Por_Hardware() ? "sí" : "no") << endl;
+    assert(RLEKernels::CRC32C(datos.data() + 777, datos.size() - 777, RLEKernels::CRC32C(datos.data(), 777)) == activo);
+
+    // CRC(A || B) a partir de CRC(A), CRC(B) y |B|
+    for (size_t corte : {(size_t)0, (size_t)1, (size_t)4096, datos.size() - 3, datos.size()}) {
+        uint32_t a = RLEKernels::CRC32C(datos.data(), corte);
+        uint32_t b = RLEKernels::CRC32C(datos.data() + corte, datos.size() - corte);
+        assert(RLEKernels::CRC32C_Combinar(a, b, datos.size() - corte) == activo && "Fallo: CRC32C_Combinar.");
+    }
+
+    // Los checksums que Dividir_En_Bloques deriva de los tokens son el CRC32C de cada bloque
+    // descomprimido: corridas largas (extendidas por combinación), literales, banderas y elementos
+    vector<uint8_t> mixto = datos_aleatorios(semilla, 5000);
+    mixto.insert(mixto.end(), 3000000, 'A');
+    mixto.insert(mixto.end(), 700, FLAG_RLE);
+    for (int k = 0; k < 20000; ++k) mixto.insert(mixto.end(), {1, 2, 3, 4});
+    vector<uint8_t> cola = datos_aleatorios(semilla, 200000);
+    mixto.insert(mixto.end(), cola.begin(), cola.end());
+    for (uint8_t codec : {RLEContainer::CODEC_RLE, RLEContainer::CODEC_RLE_VARINT, RLEContainer::CODEC_RLE_LITERALES, RLEContainer::CODEC_RLE_ELEMENTOS}) {
+        for (bool planos : {false, true}) {
+            if (planos && codec != RLEContainer::CODEC_RLE_ELEMENTOS) continue;
+            vector<uint8_t> carga = RLECompressor::Comprimir_Local(mixto, codec, codec == RLEContainer::CODEC_RLE_ELEMENTOS ? 4 : 1, planos);
+            vector<RLEContainer::Bloque> bloques = RLECompressor::Dividir_En_Bloques(carga.data(), carga.size(), 65536, codec);
+            vector<uint8_t> salida(mixto.size());
+            size_t leidos = 0, escritos = 0;
+            for (const RLEContainer::Bloque& b : bloques) {
+                assert(RLECompressor::Descomprimir_Bloque(b, carga.data() + leidos, salida.data() + escritos, codec, true) && "Fallo: Checksum de bloque.");
+                leidos += b.longitud_comprimida;
+                escritos += b.longitud_original;
+            }
+            assert(escritos == mixto.size() && salida == mixto);
+        }
+    }
+
+    cout << "  - PASÓ: CRC32C por bloque" << endl;
+}
+
 int main(int argc, char* argv[]) {
     cout << "--- EJECUCIÓN DE PRUEBAS UNITARIAS DE RLE EXTENDIDO ---" << endl;
     
     test_compresion_rle_extendido();
     test_modo_literal_escape();
     test_inversion_completa();
+    test_compresion_por_ventanas();
+    test_diferencial_aleatorio();
+    test_api_sobre_buffers();
+    test_compresion_con_hilos();
+    test_codec_varint();
+    test_codec_literales();
+    test_codec_elementos();
+    test_checksums_crc32c();
     
     cout << "\n--- TODAS LAS PRUEBAS UNITARIAS DE RLE PASARON ---" << endl;
     return 0;
@@ -14,6 +14,7 @@
 #include <cstdio>  
 #include <cstring>
 #include <string>
+#include <algorithm>
 
 using namespace std;
 
@@ -36,7 +37,7 @@ vector<uint8_t> create_test_file(const string& file_name, const vector<uint8_t>&
 }
 
 // --- Función de Prueba de Integración de Fronteras con Verificación Exacta ---
-void run_full_test_cycle(int rank, int size, const vector<uint8_t>& original_data, const string& case_name) {
+void run_full_test_cycle(int rank, int size, const vector<uint8_t>& original_data, const string& case_name, const RLEOptions& opciones = RLEOptions()) {
     if (rank == 0) {
         cout << "\n==========================================================" << endl;
         cout << "INICIANDO CASO DE PRUEBA: " << case_name << endl;
@@ -45,12 +46,35 @@ void run_full_test_cycle(int rank, int size, const vector<uint8_t>& original_dat
     }
     MPI_Barrier(MPI_COMM_WORLD);
     
-    RLECompressor::RunParallel(INPUT_FILE, OUTPUT_FILE, rank, size);
+    RLECompressor::RunParallel(INPUT_FILE, OUTPUT_FILE, rank, size, opciones);
 
     if (rank == 0) {
         cout << "\n--- Verificación Compresión (" << case_name << ") ---" << endl;
         
-        vector<uint8_t> expected_compressed = RLECompressor::Comprimir_Local(original_data);
+        vector<uint8_t> expected_compressed = RLECompressor::Comprimir_Local(original_data, opciones.codec);
+        if (opciones.dinamico) {
+            // En el reparto dinámico cada trozo se comprime de forma independiente, en orden de archivo
+            expected_compressed.clear();
+            for (size_t inicio = 0; inicio < original_data.size(); inicio += opciones.trozo_dinamico) {
+                size_t fin = min(original_data.size(), inicio + opciones.trozo_dinamico);
+                vector<uint8_t> trozo(original_data.begin() + inicio, original_data.begin() + fin);
+                vector<uint8_t> comprimido = RLECompressor::Comprimir_Local(trozo, opciones.codec);
+                expected_compressed.insert(expected_compressed.end(), comprimido.begin(), comprimido.end());
+            }
+        } else if (RLECompressor::Literales_En_Bloques(opciones.codec)) {
+            // Con bloques de literales no hay corrección de fronteras: cada proceso codifica su tramo,
+            // que con elementos empieza en una frontera de elemento
+            size_t elemento = (opciones.codec == RLEContainer::CODEC_RLE_ELEMENTOS) ? opciones.elemento : 1;
+            expected_compressed.clear();
+            for (int r = 0; r < size; ++r) {
+                uint64_t offset, longitud;
+                RLECompressor::Calcular_Particion(original_data.size(), r, size, offset, longitud, elemento);
+                assert(offset % elemento == 0 && "Fallo: El tramo no empieza en una frontera de elemento.");
+                vector<uint8_t> tramo(original_data.begin() + offset, original_data.begin() + offset + longitud);
+                vector<uint8_t> comprimido = RLECompressor::Comprimir_Local(tramo, opciones.codec, elemento, opciones.planos);
+                expected_compressed.insert(expected_compressed.end(), comprimido.begin(), comprimido.end());
+            }
+        }
         
         ifstream ifs(OUTPUT_FILE, ios::binary | ios::ate);
         if (!ifs) {
@@ -65,6 +89,12 @@ void run_full_test_cycle(int rank, int size, const vector<uint8_t>& original_dat
         ifs.read((char*)actual_compressed.data(), actual_size);
         ifs.close();
 
+        // El archivo es un contenedor por bloques: se comparan sus tokens concatenados
+        vector<uint8_t> actual_compressed_file = actual_compressed;
+        bool es_contenedor = RLECompressor::Extraer_Tokens(actual_compressed_file, actual_compressed);
+        assert(es_contenedor && "Fallo: El archivo de salida no es un contenedor válido.");
+        actual_size = actual_compressed.size();
+
         if (actual_compressed.size() == expected_compressed.size() &&
             memcmp(actual_compressed.data(), expected_compressed.data(), actual_size) == 0) {
             
@@ -87,7 +117,7 @@ void run_full_test_cycle(int rank, int size, const vector<uint8_t>& original_dat
     MPI_Barrier(MPI_COMM_WORLD);
     
     // Ejecutar la descompresión paralela
-    RLECompressor::RunParallelDecompress(OUTPUT_FILE, DECOMPRESSED_FILE, rank, size);
+    RLECompressor::RunParallelDecompress(OUTPUT_FILE, DECOMPRESSED_FILE, rank, size, opciones);
 
     // 4. Verificación Exacta Byte a Byte del archivo descomprimido (Solo Rank 0)
     if (rank == 0) {
@@ -134,9 +164,84 @@ void run_full_test_cycle(int rank, int size, const vector<uint8_t>& original_dat
     }
 }
 
+// --- Descompresión paralela de un .rle heredado (flujo RLE sin cabecera) ---
+void run_legacy_decompress_test(int rank, int size, const vector<uint8_t>& original_data) {
+    if (rank == 0) {
+        cout << "\n==========================================================" << endl;
+        cout << "INICIANDO CASO DE PRUEBA: Formato heredado sin cabecera" << endl;
+        cout << "==========================================================" << endl;
+        create_test_file(OUTPUT_FILE, RLECompressor::Comprimir_Local(original_data));
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    RLECompressor::RunParallelDecompress(OUTPUT_FILE, DECOMPRESSED_FILE, rank, size);
+
+    if (rank == 0) {
+        ifstream ifs_decomp(DECOMPRESSED_FILE, ios::binary | ios::ate);
+        size_t decompressed_size = ifs_decomp.tellg();
+        ifs_decomp.seekg(0, ios::beg);
+        vector<uint8_t> actual_decompressed(decompressed_size);
+        ifs_decomp.read((char*)actual_decompressed.data(), decompressed_size);
+        ifs_decomp.close();
+
+        if (actual_decompressed == original_data) {
+            cout << "✅ ÉXITO: El archivo heredado se descomprime byte a byte como el original." << endl;
+        } else {
+            cout << "❌ FALLO: El archivo heredado NO se descomprime correctamente." << endl;
+            assert(false);
+        }
+
+        remove(OUTPUT_FILE.c_str());
+        remove(DECOMPRESSED_FILE.c_str());
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+// Datos con costo desigual: la primera mitad son corridas de 100 bytes (muy compresibles) y la
+// segunda, bytes pseudoaleatorios (incompresibles)
+vector<uint8_t> datos_costo_desigual(size_t longitud) {
+    vector<uint8_t> datos(longitud);
+    uint32_t semilla = 7;
+    for (size_t i = 0; i < longitud; ++i) {
+        semilla = semilla * 1103515245 + 12345;
+        datos[i] = (i < longitud / 2) ? (uint8_t)(i / 100 % 200) : (uint8_t)(semilla >> 16);
+    }
+    return datos;
+}
+
+void test_particion_balanceada(int rank, int size) {
+    vector<uint8_t> datos = datos_costo_desigual(4 << 20);
+    if (rank == 0) {
+        cout << "\n--- Particionamiento balanceado por costo estimado ---" << endl;
+        create_test_file(INPUT_FILE, datos);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    MPI_File fh;
+    MPI_File_open(MPI_COMM_WORLD, INPUT_FILE.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+    RLECompressor::Particion particion = RLECompressor::Calcular_Particion_Balanceada(fh, datos.size(), rank, size);
+    MPI_File_close(&fh);
+
+    const vector<uint64_t>& cortes = particion.cortes;
+    assert(cortes.size() == (size_t)size + 1 && cortes.front() == 0 && cortes.back() == datos.size());
+    for (int r = 1; r < size; ++r) {
+        assert(cortes[r] >= cortes[r - 1] && "Fallo: Los cortes no son crecientes.");
+        assert(datos[cortes[r]] != datos[cortes[r] - 1] && "Fallo: El corte no cae en un cambio de valor.");
+    }
+    // La mitad compresible es más barata: el primer proceso recibe más de la mitad de su parte uniforme
+    assert(cortes[1] > datos.size() / size && "Fallo: El primer tramo no se amplió.");
+    assert(particion.desbalance_balanceado < particion.desbalance_uniforme && "Fallo: El desbalance estimado no mejoró.");
+
+    if (rank == 0) {
+        cout << "Desbalance estimado: " << particion.desbalance_uniforme << " -> " << particion.desbalance_balanceado << endl;
+        cout << "✅ ÉXITO: Cortes crecientes, alineados a cambios de valor y más equilibrados." << endl;
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+}
 
 int main(int argc, char* argv[]) {
-    MPI_Init(&argc, &argv);
+    int nivel_hilos;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &nivel_hilos);
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
@@ -175,6 +280,93 @@ int main(int argc, char* argv[]) {
     }; 
     run_full_test_cycle(rank, size, case3_data, "Caso 3: C-A-BBB-C (Boundary en run B con literales)");
 
+    // Caso 3b: Mismo ciclo con la salida recolectada en rank 0 (ruta MPI_Gatherv)
+    RLEOptions opciones_gather;
+    opciones_gather.escritura = ModoEscritura::Gather;
+    run_full_test_cycle(rank, size, case3_data, "Caso 3b: C-A-BBB-C (Escritura por Gather)", opciones_gather);
+
+    // Caso 3c: Ventanas de 1 byte: la corrida B cruza ventanas y fronteras entre procesos
+    RLEOptions opciones_ventana;
+    opciones_ventana.ventana = 1;
+    run_full_test_cycle(rank, size, case3_data, "Caso 3c: C-A-BBB-C (Ventanas de 1 byte)", opciones_ventana);
+
+    // Caso 3d: Hilos por proceso: corridas cortas en todas las fronteras y una corrida larga que
+    // cruza el corte entre las partes de los hilos (las partes tienen al menos TAMANO_MINIMO_PARTE)
+    vector<uint8_t> case3d_data(600000);
+    for (size_t i = 0; i < case3d_data.size(); ++i) case3d_data[i] = (uint8_t)((i / 7) % 200);
+    fill(case3d_data.begin() + 50000, case3d_data.begin() + 150000, 90);
+    RLEOptions opciones_hilos;
+    opciones_hilos.hilos = 3;
+    opciones_hilos.ventana = 256 << 10;
+    run_full_test_cycle(rank, size, case3d_data, "Caso 3d: Corridas cortas y largas (3 hilos por proceso)", opciones_hilos);
+
+    // Caso 3e: Tramos balanceados por costo estimado en lugar de bytes iguales
+    test_particion_balanceada(rank, size);
+    RLEOptions opciones_balanceo;
+    opciones_balanceo.balanceo = true;
+    run_full_test_cycle(rank, size, datos_costo_desigual(4 << 20), "Caso 3e: Costo desigual (--balance)", opciones_balanceo);
+
+    // Caso 3f: Reparto dinámico con trozos pequeños: la corrida larga cruza varios cortes entre trozos
+    RLEOptions opciones_dinamico;
+    opciones_dinamico.dinamico = true;
+    opciones_dinamico.trozo_dinamico = 40009;
+    opciones_dinamico.hilos = 2;
+    run_full_test_cycle(rank, size, case3d_data, "Caso 3f: Corridas cortas y largas (--dynamic)", opciones_dinamico);
+
+    // Caso 3g: Corridas de más de 255 bytes (incluidas banderas) que cruzan varios procesos
+    vector<uint8_t> case3g_data(size * 700 + 2, FLAG_RLE);
+    fill(case3g_data.begin(), case3g_data.begin() + 5, 65);
+    fill(case3g_data.end() - 2, case3g_data.end(), FLAG_LITERAL);
+    run_full_test_cycle(rank, size, case3g_data, "Caso 3g: Corrida de 0xFF a través de todos los procesos");
+    run_full_test_cycle(rank, size, vector<uint8_t>(size * 1000 + 1, 66), "Caso 3h: Archivo uniforme");
+
+    // Caso 3i: Conteos LEB128: la corrida que cruza todos los procesos es una sola tupla
+    RLEOptions opciones_varint;
+    opciones_varint.codec = RLEContainer::CODEC_RLE_VARINT;
+    run_full_test_cycle(rank, size, case3g_data, "Caso 3i: Corrida de 0xFF a través de todos los procesos (--codec varint)", opciones_varint);
+    run_full_test_cycle(rank, size, case3d_data, "Caso 3j: Corridas cortas y largas (--codec varint)", opciones_varint);
+
+    // Caso 3k: Bloques de literales: cada proceso codifica su tramo por separado
+    RLEOptions opciones_literales;
+    opciones_literales.codec = RLEContainer::CODEC_RLE_LITERALES;
+    run_full_test_cycle(rank, size, case3g_data, "Caso 3k: Corrida de 0xFF a través de todos los procesos (--codec literal)", opciones_literales);
+    run_full_test_cycle(rank, size, case3d_data, "Caso 3l: Corridas cortas y largas (--codec literal)", opciones_literales);
+
+    // Caso 3m: Corridas de enteros de 32 bits que cruzan las fronteras, con bytes sobrantes al final:
+    // los tramos se alinean a 4 bytes para que ningún elemento quede partido
+    vector<uint8_t> case3m_data;
+    for (uint32_t k = 0; case3m_data.size() < (size_t)size * 4000; ++k) {
+        uint32_t valor = k * 2654435761u;
+        for (uint32_t r = 0; r < 1 + k % 37; ++r) {
+            for (int b = 0; b < 4; ++b) case3m_data.push_back((uint8_t)(valor >> (8 * b)));
+        }
+    }
+    case3m_data.push_back(FLAG_RLE);
+    case3m_data.push_back(FLAG_LITERAL);
+    case3m_data.push_back(0xFD);
+    RLEOptions opciones_elementos;
+    opciones_elementos.codec = RLEContainer::CODEC_RLE_ELEMENTOS;
+    opciones_elementos.elemento = 4;
+    run_full_test_cycle(rank, size, case3m_data, "Caso 3m: Corridas de enteros de 32 bits (--element-size 4)", opciones_elementos);
+
+    // Caso 3n: Contadores de 64 bits que crecen despacio, transpuestos a planos de bytes
+    vector<uint8_t> case3n_data;
+    for (uint64_t k = 0; case3n_data.size() < (size_t)size * 8000; ++k) {
+        uint64_t valor = 1000000 + k * 3 + k % 2;
+        for (int b = 0; b < 8; ++b) case3n_data.push_back((uint8_t)(valor >> (8 * b)));
+    }
+    case3n_data.resize(case3n_data.size() - 5);
+    RLEOptions opciones_planos = opciones_elementos;
+    opciones_planos.elemento = 8;
+    opciones_planos.planos = true;
+    run_full_test_cycle(rank, size, case3n_data, "Caso 3n: Contadores de 64 bits (--element-size 8 --transpose)", opciones_planos);
+
+    // Caso 4: .rle heredado de solo literales (la ruta heredada no garantiza alinear tuplas cortadas)
+    vector<uint8_t> case4_data = {
+        65, 66, 66, 67, 68, 68, 69, 70, 71, 71, 72,
+    };
+    run_legacy_decompress_test(rank, size, case4_data);
+
 
     MPI_Finalize();
     return 0;
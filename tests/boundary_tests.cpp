@@ -115,6 +115,12 @@ void run_boundary_test(int rank, int size) {
             ifs.read((char*)actual_compressed.data(), actual_size);
             ifs.close();
 
+            // El archivo es un contenedor por bloques: se comparan sus tokens concatenados
+            vector<uint8_t> actual_compressed_file = actual_compressed;
+            bool es_contenedor = RLECompressor::Extraer_Tokens(actual_compressed_file, actual_compressed);
+            assert(es_contenedor && "Fallo: El archivo de salida no es un contenedor válido.");
+            actual_size = actual_compressed.size();
+
             if (actual_compressed.size() == expected_compressed.size() &&
                 memcmp(actual_compressed.data(), expected_compressed.data(), actual_size) == 0) {
                 
@@ -0,0 +1,605 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+
+#include "../include/RLECompressor.hpp"
+#include "../include/RLEContainer.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+const string CNT_IN_FILE = "test_data/cnt_in.bin";
+const string CNT_OUT_FILE = "test_data/cnt_out.rle";
+const string CNT_LEGACY_FILE = "test_data/cnt_legacy.rle";
+const string CNT_DECOMPRESSED_FILE = "test_data/cnt_decompressed.bin";
+const string CNT_METRICS_CSV = "test_data/cnt_metricas.csv";
+const string CNT_METRICS_JSON = "test_data/cnt_metricas.json";
+
+// --- Datos mixtos: corridas largas, literales y bytes bandera ---
+vector<uint8_t> create_mixed_data(size_t size) {
+    vector<uint8_t> data(size);
+    uint32_t semilla = 12345;
+    size_t i = 0;
+    while (i < size) {
+        semilla = semilla * 1103515245 + 12345;
+        size_t corrida = 1 + (semilla >> 16) % 600;
+        uint8_t valor = (uint8_t)(semilla >> 8);
+        for (size_t k = 0; k < corrida && i < size; ++k) data[i++] = valor;
+    }
+    return data;
+}
+
+void write_file(const string& file_name, const vector<uint8_t>& data) {
+    ofstream ofs(file_name, ios::binary);
+    ofs.write((const char*)data.data(), data.size());
+}
+
+vector<uint8_t> read_file(const string& file_name) {
+    ifstream ifs(file_name, ios::binary | ios::ate);
+    size_t size = ifs.tellg();
+    ifs.seekg(0, ios::beg);
+    vector<uint8_t> data(size);
+    ifs.read((char*)data.data(), size);
+    return data;
+}
+
+void test_serializacion_contenedor() {
+    cout << "  - Ejecutando: Serialización y lectura del contenedor" << endl;
+
+    vector<uint8_t> original = create_mixed_data(5000);
+    vector<uint8_t> carga = RLECompressor::Comprimir_Local(original);
+    vector<RLEContainer::Bloque> bloques = RLECompressor::Dividir_En_Bloques(carga.data(), carga.size(), 512);
+    assert(bloques.size() > 1 && "Fallo: Se esperaban varios bloques.");
+
+    RLEContainer::Cabecera cabecera;
+    cabecera.tamano_original = original.size();
+
+    ostringstream oss;
+    bool escrito = RLEContainer::Escribir(oss, cabecera, carga.data(), bloques);
+    assert(escrito && "Fallo: No se pudo escribir el contenedor.");
+    string serializado = oss.str();
+
+    RLEContainer::Cabecera leida;
+    vector<RLEContainer::Bloque> bloques_leidos;
+    bool ok = RLEContainer::Parsear((const uint8_t*)serializado.data(), serializado.size(), leida, bloques_leidos);
+    assert(ok && "Fallo: No se pudo analizar el contenedor.");
+    assert(leida.version == RLEContainer::VERSION);
+    assert(leida.tamano_original == original.size());
+    assert(bloques_leidos.size() == bloques.size());
+
+    // Cada bloque se descomprime por separado y reproduce su tramo del original
+    size_t posicion = 0;
+    for (const RLEContainer::Bloque& b : bloques_leidos) {
+        const uint8_t* inicio = (const uint8_t*)serializado.data() + b.offset + RLEContainer::TAMANO_REGISTRO;
+        vector<uint8_t> datos = RLECompressor::Descomprimir_Local(vector<uint8_t>(inicio, inicio + b.longitud_comprimida));
+        assert(datos.size() == b.longitud_original);
+        assert(memcmp(datos.data(), original.data() + posicion, datos.size()) == 0);
+        posicion += datos.size();
+    }
+    assert(posicion == original.size());
+
+    // Un códec desconocido en la cabecera invalida el contenedor
+    serializado[5] = RLEContainer::CODEC_MAXIMO + 1;
+    ok = RLEContainer::Parsear((const uint8_t*)serializado.data(), serializado.size(), leida, bloques_leidos);
+    assert(!ok && "Fallo: Se aceptó un códec desconocido.");
+    serializado[5] = RLEContainer::CODEC_RLE;
+
+    // Dos entradas del índice intercambiadas: los bloques ya no van seguidos
+    string desordenado = serializado;
+    size_t indice = desordenado.size() - RLEContainer::TAMANO_PIE - bloques.size() * RLEContainer::TAMANO_ENTRADA_INDICE;
+    swap_ranges(desordenado.begin() + indice, desordenado.begin() + indice + RLEContainer::TAMANO_ENTRADA_INDICE,
+                desordenado.begin() + indice + RLEContainer::TAMANO_ENTRADA_INDICE);
+    ok = RLEContainer::Parsear((const uint8_t*)desordenado.data(), desordenado.size(), leida, bloques_leidos);
+    assert(!ok && "Fallo: Se aceptó un índice fuera de orden.");
+
+    // Un offset de índice cercano a 2^64 no debe pasar por la vuelta de la suma
+    const uint64_t tamano = 24 * 1000;
+    uint8_t pie[RLEContainer::TAMANO_PIE];
+    RLEContainer::Serializar_Pie(UINT64_MAX - 23, tamano / RLEContainer::TAMANO_ENTRADA_INDICE, pie);
+    uint64_t offset_indice, num_bloques;
+    assert(!RLEContainer::Parsear_Pie(pie, tamano, offset_indice, num_bloques) && "Fallo: Se aceptó un pie que da la vuelta.");
+
+    // Un pie dañado invalida el contenedor
+    serializado[serializado.size() - 1] ^= 0xFF;
+    ok = RLEContainer::Parsear((const uint8_t*)serializado.data(), serializado.size(), leida, bloques_leidos);
+    assert(!ok && "Fallo: Se aceptó un contenedor con el pie dañado.");
+
+    cout << "  - PASÓ: Serialización y lectura del contenedor" << endl;
+}
+
+void test_bloques_en_frontera_de_token() {
+    cout << "  - Ejecutando: División de bloques en fronteras de token" << endl;
+
+    // Escapes y tuplas intercalados: ningún bloque debe cortar un token
+    vector<uint8_t> original;
+    for (int r = 0; r < 200; ++r) {
+        original.push_back(FLAG_RLE);
+        original.push_back(FLAG_LITERAL);
+        original.insert(original.end(), 7, (uint8_t)r);
+    }
+    vector<uint8_t> carga = RLECompressor::Comprimir_Local(original);
+
+    for (size_t objetivo : {1, 2, 3, 10, 100}) {
+        vector<RLEContainer::Bloque> bloques = RLECompressor::Dividir_En_Bloques(carga.data(), carga.size(), objetivo);
+        vector<uint8_t> reconstruido;
+        size_t offset = 0;
+        for (const RLEContainer::Bloque& b : bloques) {
+            vector<uint8_t> parte(carga.begin() + offset, carga.begin() + offset + b.longitud_comprimida);
+            vector<uint8_t> datos = RLECompressor::Descomprimir_Local(parte);
+            assert(datos.size() == b.longitud_original);
+            reconstruido.insert(reconstruido.end(), datos.begin(), datos.end());
+            offset += b.longitud_comprimida;
+        }
+        assert(offset == carga.size());
+        assert(reconstruido == original && "Fallo: Un bloque cortó un token.");
+    }
+
+    cout << "  - PASÓ: División de bloques en fronteras de token" << endl;
+}
+
+void test_ciclo_secuencial_multibloque() {
+    cout << "  - Ejecutando: Ciclo secuencial con varios bloques" << endl;
+
+    vector<uint8_t> original = create_mixed_data(3 * RLECompressor::TAMANO_BLOQUE + 777);
+    write_file(CNT_IN_FILE, original);
+
+    RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE);
+    RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE);
+
+    RLEContainer::Cabecera cabecera;
+    vector<RLEContainer::Bloque> bloques;
+    vector<uint8_t> archivo = read_file(CNT_OUT_FILE);
+    bool ok = RLEContainer::Parsear(archivo.data(), archivo.size(), cabecera, bloques);
+    assert(ok && "Fallo: La salida secuencial no es un contenedor válido.");
+    assert(bloques.size() >= 3 && "Fallo: Se esperaba más de un bloque.");
+
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: El ciclo secuencial no reproduce el original.");
+
+    remove(CNT_IN_FILE.c_str());
+    remove(CNT_OUT_FILE.c_str());
+    remove(CNT_DECOMPRESSED_FILE.c_str());
+    cout << "  - PASÓ: Ciclo secuencial con varios bloques" << endl;
+}
+
+void test_ventanas_secuenciales() {
+    cout << "  - Ejecutando: Compresión secuencial por ventanas pequeñas" << endl;
+
+    vector<uint8_t> original = create_mixed_data(2 * RLECompressor::TAMANO_BLOQUE + 4321);
+    write_file(CNT_IN_FILE, original);
+
+    // Una sola ventana con todo el archivo como referencia
+    RLEOptions opciones;
+    opciones.ventana = original.size();
+    RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE, opciones);
+    vector<uint8_t> referencia = read_file(CNT_OUT_FILE);
+
+    // Ventanas que no dividen el tamaño de bloque ni la longitud de las corridas
+    opciones.ventana = 4099;
+    RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE, opciones);
+    assert(read_file(CNT_OUT_FILE) == referencia && "Fallo: El contenedor depende del tamaño de ventana.");
+
+    RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: La compresión por ventanas no reproduce el original.");
+
+    // Con hilos: la ventana se comprime por partes y los bloques se descomprimen en paralelo
+    opciones.hilos = 4;
+    opciones.ventana = 700001;
+    RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE, opciones);
+    assert(read_file(CNT_OUT_FILE) == referencia && "Fallo: El contenedor depende del número de hilos.");
+
+    RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: La descompresión con hilos no reproduce el original.");
+
+    // Códec LEB128: se registra en la cabecera y la descompresión lo detecta
+    opciones.codec = RLEContainer::CODEC_RLE_VARINT;
+    RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE, opciones);
+    RLEContainer::Cabecera cabecera;
+    vector<RLEContainer::Bloque> bloques;
+    vector<uint8_t> archivo = read_file(CNT_OUT_FILE);
+    assert(RLEContainer::Parsear(archivo.data(), archivo.size(), cabecera, bloques));
+    assert(cabecera.codec == RLEContainer::CODEC_RLE_VARINT);
+    RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: El códec LEB128 no reproduce el original.");
+
+    // Bloques de literales: con ventanas e hilos cada parte se codifica por separado
+    opciones.codec = RLEContainer::CODEC_RLE_LITERALES;
+    RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE, opciones);
+    archivo = read_file(CNT_OUT_FILE);
+    assert(RLEContainer::Parsear(archivo.data(), archivo.size(), cabecera, bloques));
+    assert(cabecera.codec == RLEContainer::CODEC_RLE_LITERALES);
+    RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: El códec de bloques de literales no reproduce el original.");
+
+    remove(CNT_IN_FILE.c_str());
+    remove(CNT_OUT_FILE.c_str());
+    remove(CNT_DECOMPRESSED_FILE.c_str());
+    cout << "  - PASÓ: Compresión secuencial por ventanas pequeñas" << endl;
+}
+
+void test_lectura_formato_heredado() {
+    cout << "  - Ejecutando: Lectura de un .rle heredado sin cabecera" << endl;
+
+    vector<uint8_t> original = create_mixed_data(4096);
+    write_file(CNT_LEGACY_FILE, RLECompressor::Comprimir_Local(original));
+
+    RLECompressor::RunSequentialDecompress(CNT_LEGACY_FILE, CNT_DECOMPRESSED_FILE);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: El formato heredado no se descomprime.");
+
+    remove(CNT_LEGACY_FILE.c_str());
+    remove(CNT_DECOMPRESSED_FILE.c_str());
+    cout << "  - PASÓ: Lectura de un .rle heredado sin cabecera" << endl;
+}
+
+void test_bloques_almacenados() {
+    cout << "  - Ejecutando: Bloques almacenados sin codificar cuando RLE no reduce" << endl;
+
+    // Un bloque de bytes uniformes (con banderas que se escaparían) entre dos bloques de corridas
+    vector<uint8_t> original = create_mixed_data(RLECompressor::TAMANO_BLOQUE);
+    uint32_t semilla = 777;
+    for (size_t i = 0; i < RLECompressor::TAMANO_BLOQUE; ++i) {
+        semilla = semilla * 1103515245 + 12345;
+        original.push_back((uint8_t)(semilla >> 16));
+    }
+    vector<uint8_t> cola = create_mixed_data(RLECompressor::TAMANO_BLOQUE);
+    original.insert(original.end(), cola.begin(), cola.end());
+
+    // En memoria: la carga se compacta en su lugar y cada bloque se decodifica según su tipo
+    vector<uint8_t> carga = RLECompressor::Comprimir_Local(original);
+    vector<RLEContainer::Bloque> bloques = RLECompressor::Dividir_En_Bloques(carga.data(), carga.size(), RLECompressor::TAMANO_BLOQUE);
+    size_t longitud = RLECompressor::Almacenar_Bloques(carga.data(), bloques);
+    assert(longitud < carga.size());
+    size_t almacenados = 0, leidos = 0, escritos = 0;
+    vector<uint8_t> salida(original.size());
+    for (const RLEContainer::Bloque& b : bloques) {
+        assert(b.longitud_comprimida <= b.longitud_original && "Fallo: Un bloque crece.");
+        if (b.tipo == RLEContainer::BLOQUE_ALMACENADO) almacenados++;
+        assert(RLECompressor::Descomprimir_Bloque(b, carga.data() + leidos, salida.data() + escritos));
+        leidos += b.longitud_comprimida;
+        escritos += b.longitud_original;
+    }
+    assert(almacenados > 0 && leidos == longitud && salida == original);
+
+    // Con verificación, un byte alterado en la carga de un bloque (almacenado o RLE) se detecta
+    leidos = 0;
+    for (const RLEContainer::Bloque& b : bloques) {
+        vector<uint8_t> alterada(carga.begin() + leidos, carga.begin() + leidos + b.longitud_comprimida);
+        leidos += b.longitud_comprimida;
+        alterada[alterada.size() / 2] ^= 0x40;
+        if (!RLECompressor::Descomprimir_Bloque(b, alterada.data(), salida.data())) continue;  // Ya inválido sin checksum
+        assert(!RLECompressor::Descomprimir_Bloque(b, alterada.data(), salida.data(), RLEContainer::CODEC_RLE, true) && "Fallo: Bloque alterado no detectado.");
+    }
+
+    // De extremo a extremo: la salida no supera la entrada más los registros y la cola
+    write_file(CNT_IN_FILE, original);
+    for (uint8_t codec : {RLEContainer::CODEC_RLE, RLEContainer::CODEC_RLE_VARINT, RLEContainer::CODEC_RLE_LITERALES}) {
+        RLEOptions opciones;
+        opciones.codec = codec;
+        RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE, opciones);
+        vector<uint8_t> archivo = read_file(CNT_OUT_FILE);
+        RLEContainer::Cabecera cabecera;
+        assert(RLEContainer::Parsear(archivo.data(), archivo.size(), cabecera, bloques));
+        size_t cota = original.size() + RLEContainer::TAMANO_CABECERA + RLEContainer::TAMANO_REGISTRO + RLEContainer::TAMANO_PIE
+                    + bloques.size() * (RLEContainer::TAMANO_REGISTRO + RLEContainer::TAMANO_ENTRADA_INDICE);
+        assert(archivo.size() <= cota && "Fallo: El contenedor supera la cota de bloques almacenados.");
+
+        RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE);
+        assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: Los bloques almacenados no reproducen el original.");
+    }
+
+    // Un bloque almacenado cuya longitud no coincide con la original es corrupto
+    RLEContainer::Bloque corrupto;
+    corrupto.tipo = RLEContainer::BLOQUE_ALMACENADO;
+    corrupto.longitud_comprimida = 10;
+    corrupto.longitud_original = 11;
+    assert(!RLECompressor::Descomprimir_Bloque(corrupto, carga.data(), salida.data()));
+
+    remove(CNT_IN_FILE.c_str());
+    remove(CNT_OUT_FILE.c_str());
+    remove(CNT_DECOMPRESSED_FILE.c_str());
+    cout << "  - PASÓ: Bloques almacenados sin codificar" << endl;
+}
+
+void test_entrada_mapeada_y_salida_directa() {
+    cout << "  - Ejecutando: Entrada con mmap y salida con O_DIRECT" << endl;
+
+    // Longitud que no es múltiplo de la alineación de O_DIRECT ni del buffer de SalidaDirecta
+    vector<uint8_t> original = create_mixed_data(5 * RLECompressor::TAMANO_BLOQUE + 777);
+    write_file(CNT_IN_FILE, original);
+
+    RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE);
+    vector<uint8_t> referencia = read_file(CNT_OUT_FILE);
+
+    RLEOptions opciones;
+    opciones.entrada_mapeada = true;
+    opciones.salida_directa = true;
+    RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE, opciones);
+    assert(read_file(CNT_OUT_FILE) == referencia && "Fallo: La compresión con mmap/O_DIRECT difiere.");
+
+    RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: La descompresión con mmap/O_DIRECT no reproduce el original.");
+
+    // Archivo vacío: la proyección no tiene datos
+    write_file(CNT_IN_FILE, vector<uint8_t>());
+    RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE, opciones);
+    RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones);
+    assert(read_file(CNT_DECOMPRESSED_FILE).empty() && "Fallo: El archivo vacío no se reproduce.");
+
+    // Formato heredado leído desde la proyección
+    original = create_mixed_data(4096);
+    write_file(CNT_LEGACY_FILE, RLECompressor::Comprimir_Local(original));
+    RLECompressor::RunSequentialDecompress(CNT_LEGACY_FILE, CNT_DECOMPRESSED_FILE, opciones);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: El formato heredado no se lee con mmap.");
+
+    remove(CNT_IN_FILE.c_str());
+    remove(CNT_OUT_FILE.c_str());
+    remove(CNT_LEGACY_FILE.c_str());
+    remove(CNT_DECOMPRESSED_FILE.c_str());
+    cout << "  - PASÓ: Entrada con mmap y salida con O_DIRECT" << endl;
+}
+
+void test_metricas_por_fase() {
+    cout << "  - Ejecutando: Métricas por fase (--metrics)" << endl;
+
+    vector<uint8_t> original = create_mixed_data(2 * RLECompressor::TAMANO_BLOQUE + 99);
+    write_file(CNT_IN_FILE, original);
+
+    RLEOptions opciones;
+    opciones.metricas = CNT_METRICS_CSV;
+    RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE, opciones);
+
+    // Una fila por fase; la lectura, la codificación y el total cubren toda la entrada
+    ifstream csv(CNT_METRICS_CSV);
+    string linea;
+    getline(csv, linea);
+    assert(linea.rfind("operacion,modo,procesos,hilos,fase,", 0) == 0 && "Fallo: Encabezado CSV de métricas incorrecto.");
+    int filas = 0;
+    string tamano = "," + to_string(original.size()) + ",";
+    while (getline(csv, linea)) {
+        filas++;
+        if (linea.find(",lectura,") != string::npos || linea.find(",codificacion,") != string::npos || linea.find(",total,") != string::npos) {
+            assert(linea.find(tamano) != string::npos && "Fallo: Bytes por fase incorrectos.");
+        }
+    }
+    assert(filas == 5 && "Fallo: Faltan fases en el CSV de métricas.");
+
+    opciones.metricas = CNT_METRICS_JSON;
+    RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones);
+    stringstream json;
+    json << ifstream(CNT_METRICS_JSON).rdbuf();
+    assert(json.str().find("\"operacion\": \"descompresion\"") != string::npos);
+    assert(json.str().find("\"fase\": \"escritura\"") != string::npos && "Fallo: JSON de métricas incompleto.");
+
+    remove(CNT_IN_FILE.c_str());
+    remove(CNT_OUT_FILE.c_str());
+    remove(CNT_DECOMPRESSED_FILE.c_str());
+    remove(CNT_METRICS_CSV.c_str());
+    remove(CNT_METRICS_JSON.c_str());
+    cout << "  - PASÓ: Métricas por fase (--metrics)" << endl;
+}
+
+void test_descompresion_por_rango() {
+    cout << "  - Ejecutando: Descompresión de un rango de bytes con el índice" << endl;
+
+    // Varios bloques, una corrida larga (un bloque grande con varint) y un final que no completa bloque
+    const size_t B = RLECompressor::TAMANO_BLOQUE;
+    vector<uint8_t> original = create_mixed_data(3 * B + 1234);
+    original.insert(original.end(), 5 * B, 'Z');
+    vector<uint8_t> cola = create_mixed_data(2 * B + 77);
+    original.insert(original.end(), cola.begin(), cola.end());
+    write_file(CNT_IN_FILE, original);
+
+    for (uint8_t codec : {RLEContainer::CODEC_RLE, RLEContainer::CODEC_RLE_VARINT, RLEContainer::CODEC_RLE_LITERALES}) {
+        RLEOptions opciones;
+        opciones.codec = codec;
+        RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE, opciones);
+
+        // Rangos dentro de un bloque, cruzando fronteras de bloque, en la corrida larga, de un byte,
+        // el archivo completo y recortados al final
+        const uint64_t rangos[][2] = {{0, 1}, {100, 5000}, {B - 10, 20}, {B / 2, 2 * B}, {4 * B, B},
+                                      {3 * B, 6 * B}, {0, original.size()}, {original.size() - 5, 100},
+                                      {original.size(), 10}, {12345, 0}};
+        for (const auto& r : rangos) {
+            for (int hilos : {1, 3}) {
+                vector<uint8_t> salida;
+                assert(RLECompressor::Descomprimir_Rango(CNT_OUT_FILE, r[0], r[1], salida, true, hilos) && "Fallo: Rango no descomprimido.");
+                uint64_t fin = min<uint64_t>(r[0] + r[1], original.size());
+                assert(salida.size() == fin - r[0]);
+                assert(equal(salida.begin(), salida.end(), original.begin() + r[0]) && "Fallo: El rango no coincide con el original.");
+            }
+        }
+
+        // Un rango que empieza después del final es un error
+        vector<uint8_t> salida;
+        assert(!RLECompressor::Descomprimir_Rango(CNT_OUT_FILE, original.size() + 1, 1, salida));
+    }
+
+    // De extremo a extremo a un archivo
+    RLEOptions opciones;
+    opciones.rango = true;
+    opciones.rango_offset = 2 * B + 3;
+    opciones.rango_longitud = 4 * B;
+    RLECompressor::RunRangeDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones);
+    vector<uint8_t> esperado(original.begin() + opciones.rango_offset, original.begin() + opciones.rango_offset + opciones.rango_longitud);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == esperado && "Fallo: RunRangeDecompress no escribe el rango.");
+
+    // Los .rle heredados no tienen índice
+    write_file(CNT_LEGACY_FILE, RLECompressor::Comprimir_Local(create_mixed_data(4096)));
+    vector<uint8_t> salida;
+    assert(!RLECompressor::Descomprimir_Rango(CNT_LEGACY_FILE, 0, 10, salida) && "Fallo: Rango sobre un archivo heredado.");
+
+    remove(CNT_IN_FILE.c_str());
+    remove(CNT_OUT_FILE.c_str());
+    remove(CNT_LEGACY_FILE.c_str());
+    remove(CNT_DECOMPRESSED_FILE.c_str());
+    cout << "  - PASÓ: Descompresión de un rango de bytes" << endl;
+}
+
+void test_compresion_por_flujo() {
+    cout << "  - Ejecutando: Compresión y descompresión por flujo" << endl;
+
+    vector<uint8_t> original = create_mixed_data(3 * RLECompressor::TAMANO_BLOQUE + 555);
+    write_file(CNT_IN_FILE, original);
+
+    RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE);
+    vector<uint8_t> referencia = read_file(CNT_OUT_FILE);
+
+    // Los bloques son los mismos que en la versión secuencial; solo cambia la cabecera
+    RLECompressor::RunStreamCompress(CNT_IN_FILE, CNT_OUT_FILE);
+    vector<uint8_t> archivo = read_file(CNT_OUT_FILE);
+    RLEContainer::Cabecera cabecera;
+    vector<RLEContainer::Bloque> bloques;
+    assert(RLEContainer::Parsear(archivo.data(), archivo.size(), cabecera, bloques) && "Fallo: La salida por flujo no es un contenedor válido.");
+    assert((cabecera.banderas & RLEContainer::BANDERA_TAMANO_EN_INDICE) && cabecera.tamano_original == 0);
+    assert(archivo.size() == referencia.size() &&
+           equal(archivo.begin() + RLEContainer::TAMANO_CABECERA, archivo.end(), referencia.begin() + RLEContainer::TAMANO_CABECERA) &&
+           "Fallo: Los bloques por flujo difieren de los de la versión secuencial.");
+
+    // Lo comprimido por flujo se lee con las demás versiones y viceversa
+    RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: La descompresión secuencial no lee la salida por flujo.");
+
+    RLEOptions opciones;
+    opciones.verificar = true;
+    opciones.hilos = 3;
+    RLECompressor::RunStreamDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: La descompresión por flujo no reproduce el original.");
+
+    write_file(CNT_OUT_FILE, referencia);
+    RLECompressor::RunStreamDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: La descompresión por flujo no lee la salida secuencial.");
+
+    // Registros corruptos: se rechazan sin reservar lo que declaran (tipo desconocido, longitudes
+    // enormes, un bloque almacenado con longitudes distintas y una original que no dan los tokens)
+    const size_t R = RLEContainer::TAMANO_CABECERA;
+    vector<pair<size_t, uint8_t>> corrupciones = {{R, 7}, {R + 15, 0x40}, {R + 23, 0x40}, {R + 16, 0x01}};
+    for (const auto& c : corrupciones) {
+        vector<uint8_t> corrupto = referencia;
+        corrupto[c.first] ^= c.second;
+        write_file(CNT_OUT_FILE, corrupto);
+        assert(!RLECompressor::RunStreamDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones) && "Fallo: Se acepta un registro corrupto.");
+        assert(!ifstream(CNT_DECOMPRESSED_FILE).good() && "Fallo: Queda una salida truncada.");
+    }
+    vector<uint8_t> almacenado = referencia;
+    almacenado[R] = RLEContainer::BLOQUE_ALMACENADO;
+    write_file(CNT_OUT_FILE, almacenado);
+    assert(!RLECompressor::RunStreamDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones) && "Fallo: Se acepta un bloque almacenado inconsistente.");
+
+    // Un archivo cortado en el pie se descomprime entero, pero la salida se retira igual
+    write_file(CNT_OUT_FILE, vector<uint8_t>(referencia.begin(), referencia.end() - 1));
+    assert(!RLECompressor::RunStreamDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones) && "Fallo: Se acepta un pie truncado.");
+    assert(!ifstream(CNT_DECOMPRESSED_FILE).good() && "Fallo: Queda la salida de un contenedor sin pie.");
+
+    // Elementos de 4 bytes con una ventana que no es múltiplo del elemento y un resto final
+    opciones.codec = RLEContainer::CODEC_RLE_ELEMENTOS;
+    opciones.elemento = 4;
+    opciones.planos = true;
+    opciones.ventana = 4099;
+    RLECompressor::RunStreamCompress(CNT_IN_FILE, CNT_OUT_FILE, opciones);
+    RLECompressor::RunStreamDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones);
+    assert(read_file(CNT_DECOMPRESSED_FILE) == original && "Fallo: El flujo con elementos de 4 bytes no reproduce el original.");
+
+    // Con literales y elementos los grupos se cortan en el borde de cada ventana: la entrada llega por
+    // una tubería en trozos pequeños e irregulares y la salida debe ser la misma que la secuencial.
+    // La ventana supera un bloque para que un corte en el primer bloque completo se note.
+    RLEOptions por_ventanas[2];
+    por_ventanas[0].codec = RLEContainer::CODEC_RLE_LITERALES;
+    por_ventanas[1].codec = RLEContainer::CODEC_RLE_ELEMENTOS;
+    por_ventanas[1].elemento = 4;
+    por_ventanas[1].planos = true;
+    for (RLEOptions& o : por_ventanas) {
+        o.ventana = RLECompressor::TAMANO_BLOQUE + 4099;
+        RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE, o);
+        vector<uint8_t> secuencial = read_file(CNT_OUT_FILE);
+
+        int tubo[2];
+        assert(pipe(tubo) == 0);
+        thread escritor([&]() {
+            uint32_t semilla = 777;
+            for (size_t i = 0; i < original.size(); ) {
+                semilla = semilla * 1103515245 + 12345;
+                size_t n = min<size_t>(1 + (semilla >> 16) % 9000, original.size() - i);
+                i += write(tubo[1], original.data() + i, n);
+                // Una pausa breve deja que el lector consuma cada trozo por separado
+                if (semilla & 0x100) usleep(20);
+            }
+            close(tubo[1]);
+        });
+        bool comprimido = RLECompressor::RunStreamCompress("/dev/fd/" + to_string(tubo[0]), CNT_OUT_FILE, o);
+        escritor.join();
+        close(tubo[0]);
+
+        vector<uint8_t> flujo = read_file(CNT_OUT_FILE);
+        assert(comprimido && flujo.size() == secuencial.size() &&
+               equal(flujo.begin() + RLEContainer::TAMANO_CABECERA, flujo.end(), secuencial.begin() + RLEContainer::TAMANO_CABECERA) &&
+               "Fallo: La salida por flujo depende de cómo llega la entrada.");
+    }
+
+    remove(CNT_IN_FILE.c_str());
+    remove(CNT_OUT_FILE.c_str());
+    remove(CNT_DECOMPRESSED_FILE.c_str());
+    cout << "  - PASÓ: Compresión y descompresión por flujo" << endl;
+}
+
+void test_fallos_de_verificacion() {
+    cout << "  - Ejecutando: Los fallos de verificación se informan al llamador" << endl;
+
+    vector<uint8_t> original = create_mixed_data(2 * RLECompressor::TAMANO_BLOQUE + 321);
+    write_file(CNT_IN_FILE, original);
+    assert(RLECompressor::RunSequential(CNT_IN_FILE, CNT_OUT_FILE) && "Fallo: La compresión correcta informa un error.");
+
+    RLEOptions opciones;
+    opciones.verificar = true;
+    opciones.rango = true;
+    opciones.rango_offset = 0;
+    opciones.rango_longitud = original.size();
+    assert(RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones));
+    assert(RLECompressor::RunStreamDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones));
+    assert(RLECompressor::RunRangeDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones));
+
+    // Un byte cambiado en la carga del primer bloque no pasa el CRC32C en ninguna de las versiones
+    vector<uint8_t> archivo = read_file(CNT_OUT_FILE);
+    archivo[RLEContainer::TAMANO_CABECERA + RLEContainer::TAMANO_REGISTRO + 7] ^= 0x5A;
+    write_file(CNT_OUT_FILE, archivo);
+    assert(!RLECompressor::RunSequentialDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones) && "Fallo: Secuencial acepta un bloque corrupto.");
+    assert(!RLECompressor::RunStreamDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones) && "Fallo: Flujo acepta un bloque corrupto.");
+    assert(!RLECompressor::RunRangeDecompress(CNT_OUT_FILE, CNT_DECOMPRESSED_FILE, opciones) && "Fallo: Rango acepta un bloque corrupto.");
+
+    remove(CNT_IN_FILE.c_str());
+    remove(CNT_OUT_FILE.c_str());
+    remove(CNT_DECOMPRESSED_FILE.c_str());
+    cout << "  - PASÓ: Los fallos de verificación se informan al llamador" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    // RunSequential lee la entrada con MPI-IO (MPI_COMM_SELF); los hilos de trabajo no llaman a MPI
+    int nivel_hilos;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &nivel_hilos);
+    cout << "\n--- INICIO DE PRUEBAS DEL CONTENEDOR POR BLOQUES ---" << endl;
+
+    test_serializacion_contenedor();
+    test_bloques_en_frontera_de_token();
+    test_ciclo_secuencial_multibloque();
+    test_ventanas_secuenciales();
+    test_lectura_formato_heredado();
+    test_bloques_almacenados();
+    test_entrada_mapeada_y_salida_directa();
+    test_metricas_por_fase();
+    test_descompresion_por_rango();
+    test_compresion_por_flujo();
+    test_fallos_de_verificacion();
+
+    cout << "\n--- TODAS LAS PRUEBAS DEL CONTENEDOR PASARON ---" << endl;
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * PROYECTO: Parallel-Project-RLE
+ * @author Medina Peralta Joaquín
+ * @license General Public License (GPL) - O cualquier otra licencia que uses.
+ */
+
+#include "../include/RLECompressor.hpp"
+#include <iostream>
+#include <vector>
+#include <cassert>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <mpi.h>
+
+using namespace std;
+
+// Archivo disperso: ocupa muy poco en disco pero sus offsets superan los 2 GiB
+const string LARGE_IN_FILE = "test_data/large_in.bin";
+const string LARGE_OUT_FILE = "test_data/large_out.bin";
+const uint64_t LARGE_FILE_SIZE = (uint64_t)5 << 30;
+const uint64_t MARCA_OFFSET = (uint64_t)3 << 30;
+const size_t MARCA_LEN = 10000;
+const size_t TROZO_PRUEBA = 4096;  // Trozo pequeño para recorrer la ruta por partes sin usar gigabytes
+
+uint8_t valor_marca(uint64_t posicion) {
+    return (uint8_t)((posicion * 31) >> 3);
+}
+
+void create_sparse_file() {
+    int fd = open(LARGE_IN_FILE.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    assert(fd >= 0 && "Fallo: No se pudo crear el archivo disperso.");
+    int truncado = ftruncate(fd, LARGE_FILE_SIZE);
+    assert(truncado == 0);
+
+    vector<uint8_t> marca(MARCA_LEN);
+    for (size_t i = 0; i < MARCA_LEN; ++i) marca[i] = valor_marca(MARCA_OFFSET + i);
+    ssize_t escritos = pwrite(fd, marca.data(), MARCA_LEN, MARCA_OFFSET);
+    assert(escritos == (ssize_t)MARCA_LEN);
+    close(fd);
+}
+
+void test_particion_64_bits(int rank, int size) {
+    uint64_t offset = 0, longitud = 0, suma = 0;
+    for (int r = 0; r < size; ++r) {
+        RLECompressor::Calcular_Particion(LARGE_FILE_SIZE + 3, r, size, offset, longitud);
+        assert(offset == suma && "Fallo: Las particiones no son contiguas.");
+        suma += longitud;
+    }
+    assert(suma == LARGE_FILE_SIZE + 3);
+
+    RLECompressor::Calcular_Particion(LARGE_FILE_SIZE, size - 1, size, offset, longitud);
+    assert(offset + longitud == LARGE_FILE_SIZE);
+    if (size > 1) assert(offset > ((uint64_t)1 << 31) && "Fallo: El offset del último rank se truncó.");
+
+    if (rank == 0) cout << "  - PASÓ: Particionamiento con offsets de 64 bits" << endl;
+}
+
+void test_lectura_por_trozos(int rank) {
+    MPI_File fh;
+    MPI_File_open(MPI_COMM_WORLD, LARGE_IN_FILE.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+
+    MPI_Offset tamano = 0;
+    MPI_File_get_size(fh, &tamano);
+    assert((uint64_t)tamano == LARGE_FILE_SIZE);
+
+    // Cada rank lee un tramo distinto de la marca, que cruza varios trozos
+    uint64_t inicio = MARCA_OFFSET + rank * 1000;
+    vector<uint8_t> datos(MARCA_LEN - rank * 1000);
+    RLECompressor::Leer_MPIIO(fh, inicio, datos.data(), datos.size(), TROZO_PRUEBA);
+    MPI_File_close(&fh);
+
+    for (size_t i = 0; i < datos.size(); ++i) {
+        assert(datos[i] == valor_marca(inicio + i) && "Fallo: Lectura por trozos incorrecta.");
+    }
+    if (rank == 0) cout << "  - PASÓ: Lectura MPI-IO por trozos más allá de 2 GiB" << endl;
+}
+
+void test_escritura_colectiva_por_trozos(int rank, int size) {
+    // Longitudes desiguales: los ranks ejecutan distinto número de lotes propios
+    size_t longitud = 3000 + rank * 5000;
+    uint64_t offset = MARCA_OFFSET;
+    for (int r = 0; r < rank; ++r) offset += 3000 + r * 5000;
+
+    vector<uint8_t> datos(longitud);
+    for (size_t i = 0; i < longitud; ++i) datos[i] = valor_marca(offset + i);
+
+    MPI_File fh;
+    MPI_File_open(MPI_COMM_WORLD, LARGE_OUT_FILE.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+    RLECompressor::Escribir_MPIIO_Colectivo(fh, offset, datos.data(), datos.size(), TROZO_PRUEBA);
+    MPI_File_close(&fh);
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        uint64_t total = 0;
+        for (int r = 0; r < size; ++r) total += 3000 + r * 5000;
+
+        int fd = open(LARGE_OUT_FILE.c_str(), O_RDONLY);
+        vector<uint8_t> leido(total);
+        ssize_t n = pread(fd, leido.data(), total, MARCA_OFFSET);
+        close(fd);
+        assert(n == (ssize_t)total && "Fallo: El archivo de salida es más corto de lo esperado.");
+        for (size_t i = 0; i < total; ++i) {
+            assert(leido[i] == valor_marca(MARCA_OFFSET + i) && "Fallo: Escritura colectiva por trozos incorrecta.");
+        }
+        cout << "  - PASÓ: Escritura colectiva por trozos más allá de 2 GiB" << endl;
+    }
+}
+
+void test_recoleccion_por_trozos(int rank, int size) {
+    // Rank 0 sin datos, el resto con longitudes que no son múltiplo del trozo
+    vector<uint8_t> local(rank == 0 ? 0 : 3 * TROZO_PRUEBA + rank);
+    for (size_t i = 0; i < local.size(); ++i) local[i] = (uint8_t)(rank * 7 + i);
+
+    for (size_t trozo : {TROZO_PRUEBA, RLECompressor::TROZO_MAX_IO}) {
+        vector<uint8_t> global;
+        vector<uint64_t> longitudes = RLECompressor::Recolectar_En_Rank0(local.data(), local.size(), global, rank, size, trozo);
+
+        if (rank == 0) {
+            size_t posicion = 0;
+            for (int r = 0; r < size; ++r) {
+                assert(longitudes[r] == (r == 0 ? 0 : 3 * TROZO_PRUEBA + r));
+                for (size_t i = 0; i < longitudes[r]; ++i) {
+                    assert(global[posicion++] == (uint8_t)(r * 7 + i) && "Fallo: Recolección incorrecta.");
+                }
+            }
+            assert(posicion == global.size());
+        }
+    }
+    if (rank == 0) cout << "  - PASÓ: Recolección en rank 0 por trozos" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    MPI_Init(&argc, &argv);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (rank == 0) {
+        cout << "\n--- INICIO DE PRUEBAS DE OFFSETS GRANDES (" << size << " Procesos) ---" << endl;
+        create_sparse_file();
+        remove(LARGE_OUT_FILE.c_str());
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    test_particion_64_bits(rank, size);
+    test_lectura_por_trozos(rank);
+    test_escritura_colectiva_por_trozos(rank, size);
+    test_recoleccion_por_trozos(rank, size);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) {
+        remove(LARGE_IN_FILE.c_str());
+        remove(LARGE_OUT_FILE.c_str());
+        cout << "\n--- TODAS LAS PRUEBAS DE OFFSETS GRANDES PASARON ---" << endl;
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -101,6 +101,31 @@ void run_mpi_io_test(int rank, int size) {
     }
 }
 
+// Con alineación (ancho de elemento) los tramos empiezan en múltiplos de ella, el último proceso
+// recibe los bytes que no completan un elemento y el extra de frontera es un elemento completo.
+void run_mpi_io_alineado_test(int rank, int size) {
+    const size_t ALINEACION = 12;
+    size_t global_file_size = 0;
+    size_t offset_start = 0;
+    vector<uint8_t> buffer_in;
+
+    RLECompressor::Leer_Bloque_MPIIO(TEST_FILE, rank, size, buffer_in, global_file_size, offset_start, ALINEACION);
+
+    uint64_t offset, longitud;
+    RLECompressor::Calcular_Particion(FILE_SIZE, rank, size, offset, longitud, ALINEACION);
+    assert(offset_start == offset && offset % ALINEACION == 0);
+    assert(rank == size - 1 || longitud % ALINEACION == 0);
+    assert(buffer_in.size() == longitud + ((rank < size - 1) ? ALINEACION : 0));
+    assert(buffer_in.empty() || buffer_in[0] == (uint8_t)(offset % 256));
+
+    uint64_t total = 0;
+    MPI_Reduce(&longitud, &total, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        assert(total == FILE_SIZE);
+        cout << "PASÓ la Prueba de Lectura MPI-IO alineada a elementos de " << ALINEACION << " bytes." << endl;
+    }
+}
+
 int main(int argc, char* argv[]) {
     MPI_Init(&argc, &argv);
 
@@ -117,6 +142,7 @@ int main(int argc, char* argv[]) {
     
     try {
         run_mpi_io_test(rank, size);
+        run_mpi_io_alineado_test(rank, size);
     } catch (const std::exception& e) {
         cerr << "P" << rank << ": Excepción durante la prueba: " << e.what() << endl;
     }
@@ -54,10 +54,16 @@ void run_sequential_test() {
     ifstream ifs_out(SEQ_OUT_FILE, ios::binary | ios::ate);
     size_t actual_size = ifs_out.tellg();
     ifs_out.seekg(0, ios::beg);
-    vector<uint8_t> actual_compressed(actual_size);
-    ifs_out.read((char*)actual_compressed.data(), actual_size);
+    vector<uint8_t> actual_file(actual_size);
+    ifs_out.read((char*)actual_file.data(), actual_size);
     ifs_out.close();
 
+    // La salida es un contenedor por bloques: se comparan sus tokens
+    vector<uint8_t> actual_compressed;
+    bool es_contenedor = RLECompressor::Extraer_Tokens(actual_file, actual_compressed);
+    assert(es_contenedor && "Fallo: La salida secuencial no es un contenedor válido.");
+    actual_size = actual_compressed.size();
+
     if (actual_compressed.size() == expected_compressed.size() &&
         memcmp(actual_compressed.data(), expected_compressed.data(), actual_size) == 0) {
         
@@ -71,7 +77,10 @@ void run_sequential_test() {
     remove(SEQ_OUT_FILE.c_str());
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // RunSequential lee la entrada con MPI-IO (MPI_COMM_SELF)
+    MPI_Init(&argc, &argv);
     run_sequential_test();
+    MPI_Finalize();
     return 0;
 }
\ No newline at end of file